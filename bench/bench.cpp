@@ -0,0 +1,465 @@
+// Headless frame benchmark
+// Runs the test scenes through begin_frame/end_frame with scripted input, without opening a window
+//
+// Usage: lgui_bench [frame_count] [scene]
+//   scene: all (default), layout, widget, app, console
+// Usage: lgui_bench stress [panels] [widgets] [depth] [floating|docked] [frame_count]
+//   Generated scene, widgets is the count per panel
+// Usage: lgui_bench stress_sweep [depth] [floating|docked]
+//   Runs the stress scene over a range of panel and widget counts and prints CSV, to plot frame time against box count
+// Usage: lgui_bench huge_pages [panels] [widgets] [frame_count]
+//   Runs the stress scene with and without transparent huge pages for the arenas (Linux only)
+// Usage: lgui_bench replay <file> [hashes]
+//   Replays input recorded in the example application (F9) and prints the timings and a hash of the
+//   draw output, which should be equal between builds. "hashes" prints the hash of every frame
+
+#include "lag_gui.hpp"
+#include "test_scenes.hpp"
+#include "crc32.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+
+const lgui::v2 BENCH_WINDOW_SIZE = {1280.f, 800.f};
+const lgui::u32 BENCH_WARMUP_FRAMES = 100;
+const lgui::u32 BENCH_DEFAULT_FRAMES = 5000;
+const lgui::u32 BENCH_CONSOLE_LINES = 200;
+const lgui::f32 BENCH_DELTA_TIME = 1.f / 60.f;
+const lgui::u32 BENCH_STRESS_FRAMES = 200;
+// Address space per arena, only the pages used by the scene are committed
+const lgui::usize BENCH_STRESS_ARENA_RESERVE_MB = 4096;
+const lgui::u32 BENCH_HUGE_PAGE_ROUNDS = 3;
+
+enum BenchScene {
+	BenchScene_Layout = 1 << 0,
+	BenchScene_Widget = 1 << 1,
+	BenchScene_App = 1 << 2,
+	BenchScene_Console = 1 << 3,
+	BenchScene_All = BenchScene_Layout | BenchScene_Widget | BenchScene_App | BenchScene_Console,
+	BenchScene_Stress = 1 << 4,
+};
+
+struct BenchState {
+	lgui::u32 scenes;
+	bool no_clicks; // Only move the mouse, so the structure of the scene stays the same
+	LayoutTest layout;
+	WidgetTest widget;
+	StressTest stress;
+};
+
+struct BenchResult {
+	lgui::u32 frame_count;
+	lgui::f64 total_ns;
+	lgui::f64 min_ns;
+	lgui::f64 max_ns;
+	lgui::u64 total_boxes;
+	lgui::u64 total_vertices;
+};
+
+static lgui::u64 time_ns()
+{
+	using namespace std::chrono;
+	return (lgui::u64)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Deterministic mouse input: moves over the whole window, clicks and scrolls at a fixed rate
+static lgui::MouseState scripted_mouse(lgui::u32 frame)
+{
+	lgui::f32 t = (lgui::f32)frame * 0.01f;
+
+	lgui::MouseState ret{};
+	ret.pos.x = (sinf(t * 1.3f) * 0.5f + 0.5f) * BENCH_WINDOW_SIZE.x;
+	ret.pos.y = (sinf(t * 0.7f + 1.f) * 0.5f + 0.5f) * BENCH_WINDOW_SIZE.y;
+	ret.buttons[0] = (frame % 60) < 4;
+	ret.buttons[1] = (frame % 240) == 120;
+	ret.scroll_wheel.y = (frame % 30) == 0 ? ((frame / 30) % 2 ? 1.f : -1.f) : 0.f;
+	return ret;
+}
+
+// Deterministic key input: holds shift every other two seconds and types a character now and then
+static void scripted_keys(lgui::u32 frame)
+{
+	lgui::input_register_key_down(lgui::Key::LeftShift, (frame / 120) % 2 == 1);
+	if (frame % 45 == 0)
+	{
+		lgui::input_register_char_press('a' + (lgui::Codepoint)(frame % 26));
+	}
+}
+
+static lgui::u32 count_boxes(lgui::Box* box)
+{
+	lgui::u32 ret = 1;
+	for (lgui::Box* it = box->first_child; it; it = it->next)
+	{
+		ret += count_boxes(it);
+	}
+	return ret;
+}
+
+static lgui::u32 count_frame_boxes()
+{
+	lgui::Context* context = lgui::get_context();
+
+	lgui::u32 ret = 0;
+	for (lgui::u32 i = 0; i < context->panel_map.capacity; ++i)
+	{
+		if (!context->panel_map.entries[i].used) continue;
+		lgui::Panel* it = context->panel_map.entries[i].value;
+		// Only count panels that were built during the frame that just ended
+		if (it->frame_last_updated == context->current_frame && it->root_box)
+		{
+			ret += count_boxes(it->root_box);
+		}
+	}
+	return ret;
+}
+
+static void run_frame(BenchState& state, lgui::u32 frame)
+{
+	scripted_keys(frame);
+	lgui::MouseState mouse = scripted_mouse(frame);
+	if (state.no_clicks)
+	{
+		mouse.buttons[0] = false;
+		mouse.buttons[1] = false;
+	}
+	lgui::begin_frame(BENCH_DELTA_TIME, mouse);
+
+	if (state.scenes & BenchScene_Layout) layout_test(state.layout);
+	if (state.scenes & BenchScene_Widget) widget_test(state.widget);
+	if (state.scenes & BenchScene_App) app_test();
+	if (state.scenes & BenchScene_Console) fake_console();
+	if (state.scenes & BenchScene_Stress) stress_test(state.stress);
+
+	lgui::end_frame();
+}
+
+static BenchResult run_bench(BenchState& state, lgui::u32 frame_count)
+{
+	for (lgui::u32 i = 0; i < BENCH_WARMUP_FRAMES; ++i)
+	{
+		run_frame(state, i);
+	}
+
+	BenchResult ret{};
+	ret.min_ns = 1e30;
+	for (lgui::u32 i = 0; i < frame_count; ++i)
+	{
+		lgui::u64 start = time_ns();
+		run_frame(state, BENCH_WARMUP_FRAMES + i);
+		lgui::f64 ns = (lgui::f64)(time_ns() - start);
+
+		ret.total_ns += ns;
+		ret.min_ns = LGUI_MIN(ret.min_ns, ns);
+		ret.max_ns = LGUI_MAX(ret.max_ns, ns);
+		ret.total_boxes += count_frame_boxes();
+		ret.total_vertices += lgui::get_context()->draw_buffer.vertex_buffer_top / lgui::VERTEX_SIZE_FLOATS;
+		++ret.frame_count;
+	}
+	return ret;
+}
+
+static void print_result(const char* name, const BenchResult& result)
+{
+	lgui::f64 frames = (lgui::f64)result.frame_count;
+	printf("%-10s %8u frames  %10.0f ns/frame (min %.0f, max %.0f)  %8.1f boxes/frame  %9.1f vertices/frame\n",
+		name, result.frame_count, result.total_ns / frames, result.min_ns, result.max_ns,
+		(lgui::f64)result.total_boxes / frames, (lgui::f64)result.total_vertices / frames);
+}
+
+static bool bench_init(const lgui::InitOptions& options)
+{
+	lgui::Context* context = lgui::init(options);
+	context->app_window_size = BENCH_WINDOW_SIZE;
+
+	lgui::Font* font = context->atlas.add_font("resources/fonts/montserrat/Montserrat-Regular.ttf", 18);
+	if (!font || !context->atlas.build(false))
+	{
+		printf("Could not load fonts, run the benchmark from the repository root\n");
+		lgui::deinit();
+		return false;
+	}
+	lgui::push_style(make_test_style(font));
+	return true;
+}
+
+static bool bench_scene(const char* name, lgui::u32 scenes, lgui::u32 frame_count)
+{
+	lgui::InitOptions options{};
+	options.arena_size_mb = 16;
+	if (!bench_init(options))
+	{
+		return false;
+	}
+
+	BenchState state{};
+	state.scenes = scenes;
+	state.layout.enable = true;
+	state.layout.layout_count = 20;
+
+	BenchResult result = run_bench(state, frame_count);
+	print_result(name, result);
+
+	lgui::deinit();
+	return true;
+}
+
+// Prints how much of the memory of the process is backed by transparent huge pages
+static void print_huge_page_usage()
+{
+#ifdef __linux__
+	FILE* file = fopen("/proc/self/smaps_rollup", "r");
+	if (!file)
+	{
+		return;
+	}
+	char line[256];
+	while (fgets(line, sizeof(line), file))
+	{
+		if (strncmp(line, "AnonHugePages:", 14) == 0)
+		{
+			printf("  %s", line);
+		}
+	}
+	fclose(file);
+#endif
+}
+
+static bool bench_stress(const StressTest& stress, lgui::u32 frame_count, BenchResult* result, bool huge_pages = false)
+{
+	// The arenas grow with the scene
+	lgui::InitOptions options{};
+	options.arena_size_mb = 16;
+	options.arena_reserve_mb = BENCH_STRESS_ARENA_RESERVE_MB;
+	options.huge_pages = huge_pages;
+	if (!bench_init(options))
+	{
+		return false;
+	}
+
+	BenchState state{};
+	state.scenes = BenchScene_Stress;
+	state.no_clicks = true;
+	state.stress = stress;
+
+	*result = run_bench(state, frame_count);
+	if (huge_pages)
+	{
+		print_huge_page_usage();
+	}
+
+	lgui::deinit();
+	return true;
+}
+
+static int stress_main(int argc, char** argv)
+{
+	StressTest stress{};
+	stress.panel_count = argc > 2 ? atoi(argv[2]) : 50;
+	stress.widget_count = argc > 3 ? atoi(argv[3]) : 100;
+	stress.depth = argc > 4 ? atoi(argv[4]) : 2;
+	stress.docked = argc > 5 && strcmp(argv[5], "docked") == 0;
+	stress.widget_mix = StressWidget_All;
+	lgui::u32 frame_count = argc > 6 ? (lgui::u32)atoi(argv[6]) : BENCH_STRESS_FRAMES;
+
+	BenchResult result;
+	if (!bench_stress(stress, frame_count, &result))
+	{
+		return 1;
+	}
+	printf("%d panels, %d widgets per panel, depth %d, %s\n",
+		stress.panel_count, stress.widget_count, stress.depth, stress.docked ? "docked" : "floating");
+	print_result("stress", result);
+	return 0;
+}
+
+static int huge_pages_main(int argc, char** argv)
+{
+	StressTest stress{};
+	stress.panel_count = argc > 2 ? atoi(argv[2]) : 128;
+	stress.widget_count = argc > 3 ? atoi(argv[3]) : 250;
+	stress.depth = 2;
+	stress.widget_mix = StressWidget_All;
+	lgui::u32 frame_count = argc > 4 ? (lgui::u32)atoi(argv[4]) : BENCH_STRESS_FRAMES;
+
+	printf("%d panels, %d widgets per panel\n", stress.panel_count, stress.widget_count);
+	// Alternate the runs, so changes in the machine state affect both
+	for (lgui::u32 round = 0; round < BENCH_HUGE_PAGE_ROUNDS; ++round)
+	{
+		for (int huge_pages = 0; huge_pages < 2; ++huge_pages)
+		{
+			BenchResult result;
+			if (!bench_stress(stress, frame_count, &result, huge_pages))
+			{
+				return 1;
+			}
+			print_result(huge_pages ? "huge" : "normal", result);
+		}
+	}
+	return 0;
+}
+
+static int stress_sweep_main(int argc, char** argv)
+{
+	const int panel_counts[] = {1, 8, 32, 64, 128, 256, 512};
+	const int widget_counts[] = {10, 50, 100, 250, 500};
+
+	StressTest stress{};
+	stress.depth = argc > 2 ? atoi(argv[2]) : 2;
+	stress.docked = argc > 3 && strcmp(argv[3], "docked") == 0;
+	stress.widget_mix = StressWidget_All;
+
+	printf("panels,widgets,depth,docked,boxes_per_frame,vertices_per_frame,ns_per_frame,ns_per_box\n");
+	for (int panels : panel_counts)
+	{
+		for (int widgets : widget_counts)
+		{
+			stress.panel_count = panels;
+			stress.widget_count = widgets;
+
+			BenchResult result;
+			if (!bench_stress(stress, BENCH_STRESS_FRAMES, &result))
+			{
+				return 1;
+			}
+			lgui::f64 frames = (lgui::f64)result.frame_count;
+			lgui::f64 boxes = (lgui::f64)result.total_boxes / frames;
+			lgui::f64 ns = result.total_ns / frames;
+			printf("%d,%d,%d,%d,%.0f,%.0f,%.0f,%.2f\n", panels, widgets, stress.depth, stress.docked ? 1 : 0,
+				boxes, (lgui::f64)result.total_vertices / frames, ns, ns / LGUI_MAX(boxes, 1.0));
+			fflush(stdout);
+		}
+	}
+	return 0;
+}
+
+static bool bench_replay(const char* filename, bool print_hashes)
+{
+	lgui::Context* context = lgui::init(16);
+
+	// Same fonts as the example application, so the atlas and the output hashes match
+	lgui::Font* font = context->atlas.add_font("resources/fonts/montserrat/Montserrat-Regular.ttf", 18);
+	lgui::Font* mono_font = context->atlas.add_font("resources/fonts/ubuntu/UbuntuMono-R.ttf", 18);
+	if (!font || !mono_font || !context->atlas.build(false))
+	{
+		printf("Could not load fonts, run the benchmark from the repository root\n");
+		lgui::deinit();
+		return false;
+	}
+	lgui::push_style(make_test_style(font));
+
+	if (!lgui::input_replay_begin(filename))
+	{
+		printf("Could not open recording \"%s\"\n", filename);
+		lgui::deinit();
+		return false;
+	}
+
+	ExampleApp app{};
+	BenchResult result{};
+	result.min_ns = 1e30;
+	lgui::u32 hash = 0;
+	for (;;)
+	{
+		// Includes reading the frame from the file
+		lgui::u64 start = time_ns();
+		if (!lgui::input_replay_frame())
+		{
+			break;
+		}
+		example_app_frame(app);
+		lgui::end_frame();
+		lgui::f64 ns = (lgui::f64)(time_ns() - start);
+
+		result.total_ns += ns;
+		result.min_ns = LGUI_MIN(result.min_ns, ns);
+		result.max_ns = LGUI_MAX(result.max_ns, ns);
+		result.total_boxes += count_frame_boxes();
+		result.total_vertices += context->draw_buffer.vertex_buffer_top / lgui::VERTEX_SIZE_FLOATS;
+
+		lgui::u32 frame_hash = lgui::get_draw_buffer_hash();
+		hash = xcrc32((const unsigned char*)&frame_hash, (int)sizeof(frame_hash), hash);
+		if (print_hashes)
+		{
+			printf("frame %u: %08x\n", result.frame_count, frame_hash);
+		}
+		++result.frame_count;
+	}
+
+	if (result.frame_count > 0)
+	{
+		print_result("replay", result);
+	}
+	printf("output hash %08x\n", hash);
+
+	lgui::deinit();
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && strcmp(argv[1], "stress") == 0)
+	{
+		return stress_main(argc, argv);
+	}
+	if (argc > 1 && strcmp(argv[1], "stress_sweep") == 0)
+	{
+		return stress_sweep_main(argc, argv);
+	}
+	if (argc > 1 && strcmp(argv[1], "huge_pages") == 0)
+	{
+		return huge_pages_main(argc, argv);
+	}
+	if (argc > 2 && strcmp(argv[1], "replay") == 0)
+	{
+		bool print_hashes = argc > 3 && strcmp(argv[3], "hashes") == 0;
+		return bench_replay(argv[2], print_hashes) ? 0 : 1;
+	}
+
+	lgui::u32 frame_count = argc > 1 ? (lgui::u32)atoi(argv[1]) : BENCH_DEFAULT_FRAMES;
+	const char* scene = argc > 2 ? argv[2] : "all";
+	if (frame_count == 0)
+	{
+		frame_count = BENCH_DEFAULT_FRAMES;
+	}
+
+	for (lgui::u32 i = 0; i < BENCH_CONSOLE_LINES; ++i)
+	{
+		print("console line %u", i);
+	}
+
+	struct {
+		const char* name;
+		lgui::u32 scenes;
+	} scenes[] = {
+		{"layout", BenchScene_Layout},
+		{"widget", BenchScene_Widget},
+		{"app", BenchScene_App},
+		{"console", BenchScene_Console},
+		{"all", BenchScene_All},
+	};
+
+	bool found = false;
+	for (auto& it : scenes)
+	{
+		bool run_all = strcmp(scene, "all") == 0;
+		if (run_all || strcmp(scene, it.name) == 0)
+		{
+			found = true;
+			if (!bench_scene(it.name, it.scenes, frame_count))
+			{
+				return 1;
+			}
+		}
+	}
+
+	if (!found)
+	{
+		printf("Unknown scene \"%s\" (use all, layout, widget, app or console)\n", scene);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,625 @@
+// Microbenchmarks of the hot primitives
+// Every benchmark is measured SAMPLE_COUNT times, the median is the reported number
+//
+// Usage: lgui_microbench [filter]
+//   filter: only run benchmarks whose name contains this string
+
+#include "lag_gui.hpp"
+#include "test_scenes.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <algorithm>
+
+const lgui::u32 SAMPLE_COUNT = 25;
+const lgui::u32 WARMUP_SAMPLES = 3;
+// Indices written per sample by the painter benchmarks, the draw buffer holds DRAW_INDEX_MAX
+const lgui::usize PAINTER_INDEX_BUDGET = 48000;
+const lgui::u32 BOX_COUNT = 2048;
+// Boxes of one panel in the list benchmarks
+const lgui::u32 LIST_COUNT = 20000;
+
+// Label lengths seen in a typical UI
+const char* LABELS[] = {
+	"OK",
+	"Volume",
+	"Instrument Volume",
+	"Right Window##settings",
+	"Some longer label that is used in a tree node or a table row",
+};
+const char* DRAW_TEXT = "Instrument Volume 42%";
+
+// Keeps the optimizer from removing the measured work
+static volatile lgui::u32 g_sink;
+
+struct Sample {
+	lgui::u64 ns;
+	lgui::u32 ops;
+};
+
+struct MicroBench {
+	const char* name;
+	// Runs one sample, only the measured part is timed
+	Sample(*run)();
+};
+
+static lgui::u64 time_ns()
+{
+	using namespace std::chrono;
+	return (lgui::u64)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static lgui::Font* default_font()
+{
+	return lgui::get_style().default_font;
+}
+
+// Frame with a single full screen panel, for the benchmarks that need a current panel or painter
+static void begin_bench_frame(const char* panel_name = "micro_bench")
+{
+	lgui::begin_frame(1.f / 60.f, lgui::MouseState{});
+	lgui::begin_window(panel_name, lgui::Rect::from_pos_size({}, lgui::get_context()->app_window_size),
+		lgui::PanelFlag_NoTitleBar | lgui::PanelFlag_NoMove);
+}
+
+static void end_bench_frame()
+{
+	lgui::end_window();
+	lgui::end_frame();
+}
+
+// ID
+
+static Sample bench_get_id()
+{
+	const lgui::u32 iterations = 20000;
+	lgui::u32 sink = 0;
+
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < iterations; ++i)
+	{
+		sink += lgui::get_id(LABELS[i % LGUI_ARRAY_SIZE(LABELS)]);
+	}
+	lgui::u64 end = time_ns();
+
+	g_sink = sink;
+	return {end - start, iterations};
+}
+
+static Sample bench_get_id_literal()
+{
+	// Same labels as bench_get_id, hashed by the compiler
+	const lgui::IDLiteral labels[] = {
+		LGUI_ID_LIT("OK"),
+		LGUI_ID_LIT("Volume"),
+		LGUI_ID_LIT("Instrument Volume"),
+		LGUI_ID_LIT("Right Window##settings"),
+		LGUI_ID_LIT("Some longer label that is used in a tree node or a table row"),
+	};
+	const lgui::u32 iterations = 20000;
+	lgui::u32 sink = 0;
+
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < iterations; ++i)
+	{
+		sink += lgui::get_id(labels[i % LGUI_ARRAY_SIZE(labels)]);
+	}
+	lgui::u64 end = time_ns();
+
+	g_sink = sink;
+	return {end - start, iterations};
+}
+
+// Hash policies over label lengths, independent of the policy the library is built with
+// The label is changed every iteration so the hash can't be hoisted out of the loop
+template<lgui::u32(*Hash)(const lgui::byte*, lgui::usize, lgui::u32), lgui::usize Length>
+static Sample bench_hash()
+{
+	const lgui::u32 iterations = 20000;
+	lgui::byte label[Length];
+	for (lgui::usize i = 0; i < Length; ++i)
+	{
+		label[i] = (lgui::byte)('a' + i % 26);
+	}
+	lgui::u32 sink = 0;
+
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < iterations; ++i)
+	{
+		label[0] = (lgui::byte)i;
+		sink += Hash(label, Length, 123456);
+	}
+	lgui::u64 end = time_ns();
+
+	g_sink = sink;
+	return {end - start, iterations};
+}
+
+// Widgets
+
+// Rows of buttons in one frame, the labels are either strings or hashed by the compiler
+// Both share their IDs, the difference is the strlen and hash of every string label
+static Sample bench_buttons(bool literal)
+{
+	const lgui::Label literals[] = {
+		LGUI_ID_LIT("OK"),
+		LGUI_ID_LIT("Volume"),
+		LGUI_ID_LIT("Instrument Volume"),
+		LGUI_ID_LIT("Right Window##settings"),
+		LGUI_ID_LIT("Some longer label that is used in a tree node or a table row"),
+	};
+	const lgui::u32 rows = 200;
+	lgui::u32 sink = 0;
+
+	begin_bench_frame();
+	lgui::u64 start = time_ns();
+	for (lgui::u32 row = 0; row < rows; ++row)
+	{
+		lgui::push_id((lgui::i32)row);
+		for (lgui::u32 i = 0; i < LGUI_ARRAY_SIZE(LABELS); ++i)
+		{
+			lgui::InputResult input = literal ? lgui::button(literals[i]) : lgui::button(LABELS[i]);
+			sink += input.hover;
+		}
+		lgui::pop_id();
+	}
+	lgui::u64 end = time_ns();
+	end_bench_frame();
+
+	g_sink = sink;
+	return {end - start, rows * (lgui::u32)LGUI_ARRAY_SIZE(LABELS)};
+}
+
+// Static text is drawn from the string itself, it is neither hashed nor interned
+static Sample bench_text_static()
+{
+	const lgui::u32 rows = 200;
+
+	begin_bench_frame();
+	lgui::u64 start = time_ns();
+	for (lgui::u32 row = 0; row < rows; ++row)
+	{
+		for (lgui::u32 i = 0; i < LGUI_ARRAY_SIZE(LABELS); ++i)
+		{
+			lgui::text(LABELS[i], true);
+		}
+	}
+	lgui::u64 end = time_ns();
+	end_bench_frame();
+
+	return {end - start, rows * (lgui::u32)LGUI_ARRAY_SIZE(LABELS)};
+}
+
+// Many distinct labels that are all alive, the interned string table has to hold them all
+template<lgui::u32 Count>
+static Sample bench_buttons_distinct()
+{
+	static char labels[Count][16];
+	if (!labels[0][0])
+	{
+		for (lgui::u32 i = 0; i < Count; ++i)
+		{
+			snprintf(labels[i], sizeof(labels[i]), "Item %u", i);
+		}
+	}
+	lgui::u32 sink = 0;
+
+	begin_bench_frame();
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < Count; ++i)
+	{
+		sink += lgui::button(labels[i]).hover;
+	}
+	lgui::u64 end = time_ns();
+	end_bench_frame();
+
+	g_sink = sink;
+	return {end - start, Count};
+}
+
+static Sample bench_buttons_string() { return bench_buttons(false); }
+static Sample bench_buttons_literal() { return bench_buttons(true); }
+
+// Box lookup
+
+static Sample bench_allocate_box(bool hit)
+{
+	static lgui::u32 frame = 0;
+	++frame;
+
+	// Hits look up the ids that were allocated in the previous frame, misses use ids that were never used
+	lgui::u32 base = hit ? 0 : frame * BOX_COUNT;
+	lgui::u32 sink = 0;
+
+	begin_bench_frame();
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < BOX_COUNT; ++i)
+	{
+		lgui::Box* box = lgui::_allocate_box(lgui::get_id((lgui::i32)(base + i)));
+		sink += box->id;
+	}
+	lgui::u64 end = time_ns();
+	end_bench_frame();
+
+	g_sink = sink;
+	return {end - start, BOX_COUNT};
+}
+
+static Sample bench_allocate_box_hit() { return bench_allocate_box(true); }
+static Sample bench_allocate_box_miss() { return bench_allocate_box(false); }
+
+// A list of boxes in one panel that changes between frames like a sorted or filtered table
+// In order the previous frame's next box is always the expected one, otherwise most boxes go through the lookup table
+// Filtered leaves out a different third of the rows every frame, so a third of the lookups find nothing
+enum ListChange {
+	ListChange_InOrder,
+	ListChange_Reordered,
+	ListChange_Filtered,
+};
+
+static Sample bench_list(ListChange change)
+{
+	static lgui::u32 frame = 0;
+	++frame;
+	lgui::u32 count = 0;
+
+	begin_bench_frame();
+	lgui::u64 start = time_ns();
+	lgui::push_box(lgui::get_id(LGUI_ID_LIT("list")), lgui::px(100.f, 100.f), 0);
+	for (lgui::u32 i = 0; i < LIST_COUNT; ++i)
+	{
+		lgui::u32 row = i;
+		if (change == ListChange_Reordered)
+		{
+			// Sort direction flips every frame, so the expected next box is never the right one
+			row = frame % 2 ? LIST_COUNT - 1 - i : i;
+		}
+		else if (change == ListChange_Filtered && (i + frame) % 3 == 0)
+		{
+			continue;
+		}
+		lgui::make_box(lgui::get_id((lgui::i32)row), lgui::px(1.f, 1.f), 0);
+		++count;
+	}
+	lgui::pop_box();
+	lgui::u64 end = time_ns();
+	end_bench_frame();
+
+	return {end - start, count};
+}
+
+static Sample bench_list_in_order() { return bench_list(ListChange_InOrder); }
+static Sample bench_list_reordered() { return bench_list(ListChange_Reordered); }
+static Sample bench_list_filtered() { return bench_list(ListChange_Filtered); }
+
+static Sample bench_get_id_reference()
+{
+	// Cost of get_id on an integer, to subtract from the box lookups
+	const lgui::u32 iterations = BOX_COUNT;
+	lgui::u32 sink = 0;
+
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < iterations; ++i)
+	{
+		sink += lgui::get_id((lgui::i32)i);
+	}
+	lgui::u64 end = time_ns();
+
+	g_sink = sink;
+	return {end - start, iterations};
+}
+
+// Hash maps
+
+// The panel map and the retained data lookups are HashMaps
+// Lookups of existing keys in a scattered order, 7919 is coprime with every Count
+template<lgui::u32 Count>
+static Sample bench_hash_map_find()
+{
+	static lgui::Arena arena = lgui::Arena::from_memory(malloc(8 << 20), 8 << 20);
+	static lgui::BlockAllocator blocks;
+	static lgui::HashMap<lgui::u32> map;
+	static lgui::u32 keys[Count];
+	if (!map.count)
+	{
+		blocks.arena = &arena;
+		map.allocator = &blocks;
+		for (lgui::u32 i = 0; i < Count; ++i)
+		{
+			keys[i] = lgui::hash_bytes((const lgui::byte*)&i, sizeof(i), 0);
+			*map.insert(keys[i]) = i;
+		}
+	}
+
+	const lgui::u32 iterations = 20000;
+	lgui::u32 sink = 0;
+
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < iterations; ++i)
+	{
+		sink += *map.find(keys[(lgui::u64)i * 7919 % Count]);
+	}
+	lgui::u64 end = time_ns();
+
+	g_sink = sink;
+	return {end - start, iterations};
+}
+
+// One panel with Count stateful widgets, the first sample creates them
+template<lgui::u32 Count>
+static Sample bench_retained_data()
+{
+	static lgui::ID ids[Count];
+	char panel_name[32];
+	snprintf(panel_name, sizeof(panel_name), "retained %u", Count);
+	const lgui::u32 iterations = 20000;
+	lgui::u32 sink = 0;
+
+	begin_bench_frame(panel_name);
+	for (lgui::u32 i = 0; i < Count; ++i)
+	{
+		ids[i] = lgui::get_id((lgui::i32)i);
+		lgui::get_retained_data(ids[i]);
+	}
+
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < iterations; ++i)
+	{
+		sink += lgui::get_retained_data(ids[(lgui::u64)i * 7919 % Count])->id;
+	}
+	lgui::u64 end = time_ns();
+	end_bench_frame();
+
+	g_sink = sink;
+	return {end - start, iterations};
+}
+
+// Arena
+
+// Boxes of a 20k box frame, written once after the allocation like _allocate_box does
+// The difference between the two is the cost of zeroing them first
+static Sample bench_arena_boxes(bool zeroed)
+{
+	const lgui::u32 iterations = 20000;
+	lgui::ArenaMarker scratch = lgui::get_scratch();
+	lgui::Box prototype{};
+	prototype.h_align = -1;
+	prototype.v_align = -1;
+	lgui::u32 sink = 0;
+
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < iterations; ++i)
+	{
+		lgui::Box* box = zeroed ? scratch.arena->allocate_one<lgui::Box>(lgui::CACHE_LINE_SIZE) :
+			scratch.arena->allocate_one_raw<lgui::Box>(lgui::CACHE_LINE_SIZE);
+		*box = prototype;
+		box->id = i;
+		sink += box->id;
+	}
+	lgui::u64 end = time_ns();
+
+	g_sink = sink;
+	return {end - start, iterations};
+}
+
+static Sample bench_arena_boxes_zeroed() { return bench_arena_boxes(true); }
+static Sample bench_arena_boxes_raw() { return bench_arena_boxes(false); }
+
+// Font
+
+static Sample bench_text_width()
+{
+	const lgui::u32 iterations = 20000;
+	lgui::Font* font = default_font();
+	lgui::f32 sink = 0.f;
+
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < iterations; ++i)
+	{
+		sink += font->text_width(LABELS[i % LGUI_ARRAY_SIZE(LABELS)], 0.f);
+	}
+	lgui::u64 end = time_ns();
+
+	g_sink = (lgui::u32)sink;
+	return {end - start, iterations};
+}
+
+// Painter
+// Amount of draws per sample is chosen so the indices fit in PAINTER_INDEX_BUDGET
+
+template<typename F>
+static Sample bench_painter(F draw)
+{
+	begin_bench_frame();
+	lgui::Painter& painter = lgui::get_painter();
+
+	// Measure the size of a single draw
+	lgui::usize index_start = painter.current_command->index_end;
+	draw(painter, 0);
+	lgui::usize indices = painter.current_command->index_end - index_start;
+	lgui::u32 iterations = (lgui::u32)LGUI_MAX(PAINTER_INDEX_BUDGET / LGUI_MAX(indices, (lgui::usize)1), (lgui::usize)2);
+
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 1; i < iterations; ++i)
+	{
+		draw(painter, i);
+	}
+	lgui::u64 end = time_ns();
+	end_bench_frame();
+
+	return {end - start, iterations - 1};
+}
+
+static lgui::v2 bench_pos(lgui::u32 i)
+{
+	return {(lgui::f32)(i % 64) * 16.f, (lgui::f32)(i / 64 % 64) * 12.f};
+}
+
+static Sample bench_draw_text()
+{
+	return bench_painter([](lgui::Painter& painter, lgui::u32 i) {
+		painter.draw_text(default_font(), DRAW_TEXT, bench_pos(i), 0.f, {1.f, 1.f, 1.f, 1.f});
+	});
+}
+
+static Sample bench_draw_rectangle()
+{
+	return bench_painter([](lgui::Painter& painter, lgui::u32 i) {
+		painter.draw_rectangle(bench_pos(i), {12.f, 10.f}, {0.4f, 0.4f, 0.9f, 1.f});
+	});
+}
+
+static Sample bench_draw_circle()
+{
+	return bench_painter([](lgui::Painter& painter, lgui::u32 i) {
+		painter.draw_circle(bench_pos(i), 6.f, 1.f, {0.4f, 0.4f, 0.9f, 1.f});
+	});
+}
+
+static Sample bench_draw_rounded_rectangle()
+{
+	return bench_painter([](lgui::Painter& painter, lgui::u32 i) {
+		lgui::f32 corners[4] = {4.f, 4.f, 4.f, 4.f};
+		painter.draw_rounded_rectangle(lgui::Rect::from_pos_size(bench_pos(i), {60.f, 20.f}), corners, {0.4f, 0.4f, 0.9f, 1.f});
+	});
+}
+
+// Layout
+
+static Sample bench_end_calculate_size(lgui::SizeTypes type)
+{
+	const lgui::u32 iterations = 20000;
+
+	lgui::Box parent{};
+	parent.flags = lgui::BoxFlag_IsHorizontal;
+	lgui::Box child{};
+	child.parent = &parent;
+	child.size[0] = {(lgui::u32)type, 20.f};
+	child.size[1] = {(lgui::u32)type, 20.f};
+
+	lgui::u64 start = time_ns();
+	for (lgui::u32 i = 0; i < iterations; ++i)
+	{
+		child.is_size_calculated[0] = false;
+		child.is_size_calculated[1] = false;
+		child.end_calculate_size(0);
+		child.end_calculate_size(1);
+	}
+	lgui::u64 end = time_ns();
+
+	g_sink = (lgui::u32)parent.used_size.x;
+	return {end - start, iterations};
+}
+
+static Sample bench_end_calculate_size_px() { return bench_end_calculate_size(lgui::SizeType_Px); }
+// Fit with all children known, the size can be calculated right away
+static Sample bench_end_calculate_size_fit() { return bench_end_calculate_size(lgui::SizeType_Fit); }
+
+static void run_bench(const MicroBench& bench)
+{
+	for (lgui::u32 i = 0; i < WARMUP_SAMPLES; ++i)
+	{
+		bench.run();
+	}
+
+	lgui::f64 ns_per_op[SAMPLE_COUNT];
+	lgui::f64 mean = 0.0;
+	for (lgui::u32 i = 0; i < SAMPLE_COUNT; ++i)
+	{
+		Sample sample = bench.run();
+		ns_per_op[i] = (lgui::f64)sample.ns / (lgui::f64)sample.ops;
+		mean += ns_per_op[i];
+	}
+	mean /= (lgui::f64)SAMPLE_COUNT;
+
+	lgui::f64 variance = 0.0;
+	for (lgui::f64 it : ns_per_op)
+	{
+		variance += (it - mean) * (it - mean);
+	}
+	lgui::f64 stddev = sqrt(variance / (lgui::f64)(SAMPLE_COUNT - 1));
+
+	std::sort(ns_per_op, ns_per_op + SAMPLE_COUNT);
+	lgui::f64 median = ns_per_op[SAMPLE_COUNT / 2];
+
+	printf("%-28s %10.2f ns/op  %10.2f Mops/s  (min %.2f, max %.2f, mean %.2f, stddev %.1f%%)\n",
+		bench.name, median, 1000.0 / median, ns_per_op[0], ns_per_op[SAMPLE_COUNT - 1], mean, stddev / mean * 100.0);
+}
+
+int main(int argc, char** argv)
+{
+	const char* filter = argc > 1 ? argv[1] : "";
+
+	lgui::Context* context = lgui::init(64);
+	context->app_window_size = {1280.f, 800.f};
+
+	lgui::Font* font = context->atlas.add_font("resources/fonts/montserrat/Montserrat-Regular.ttf", 18);
+	if (!font || !context->atlas.build(false))
+	{
+		printf("Could not load fonts, run the benchmark from the repository root\n");
+		lgui::deinit();
+		return 1;
+	}
+	lgui::push_style(make_test_style(font));
+
+	MicroBench benches[] = {
+		{"get_id (string)", bench_get_id},
+		{"get_id (literal)", bench_get_id_literal},
+		{"get_id (i32)", bench_get_id_reference},
+		{"hash table 4 bytes", bench_hash<lgui::hash_crc32_table, 4>},
+		{"hash table 16 bytes", bench_hash<lgui::hash_crc32_table, 16>},
+		{"hash table 64 bytes", bench_hash<lgui::hash_crc32_table, 64>},
+		{"hash table 256 bytes", bench_hash<lgui::hash_crc32_table, 256>},
+		{"hash sse42 4 bytes", bench_hash<lgui::hash_crc32_sse42, 4>},
+		{"hash sse42 16 bytes", bench_hash<lgui::hash_crc32_sse42, 16>},
+		{"hash sse42 64 bytes", bench_hash<lgui::hash_crc32_sse42, 64>},
+		{"hash sse42 256 bytes", bench_hash<lgui::hash_crc32_sse42, 256>},
+		{"hash fast64 4 bytes", bench_hash<lgui::hash_fast64, 4>},
+		{"hash fast64 16 bytes", bench_hash<lgui::hash_fast64, 16>},
+		{"hash fast64 64 bytes", bench_hash<lgui::hash_fast64, 64>},
+		{"hash fast64 256 bytes", bench_hash<lgui::hash_fast64, 256>},
+		{"button (string)", bench_buttons_string},
+		{"button (literal)", bench_buttons_literal},
+		{"text (static)", bench_text_static},
+		{"button 1k distinct labels", bench_buttons_distinct<1000>},
+		{"button 50k distinct labels", bench_buttons_distinct<50000>},
+		{"_allocate_box hit", bench_allocate_box_hit},
+		{"_allocate_box miss", bench_allocate_box_miss},
+		{"list 20k in order", bench_list_in_order},
+		{"list 20k reordered", bench_list_reordered},
+		{"list 20k filtered", bench_list_filtered},
+		{"HashMap find 10", bench_hash_map_find<10>},
+		{"HashMap find 1k", bench_hash_map_find<1000>},
+		{"HashMap find 100k", bench_hash_map_find<100000>},
+		{"get_retained_data 10", bench_retained_data<10>},
+		{"get_retained_data 1k", bench_retained_data<1000>},
+		{"get_retained_data 100k", bench_retained_data<100000>},
+		{"arena Box (zeroed)", bench_arena_boxes_zeroed},
+		{"arena Box (raw)", bench_arena_boxes_raw},
+		{"Font::text_width", bench_text_width},
+		{"Painter::draw_text", bench_draw_text},
+		{"Painter::draw_rectangle", bench_draw_rectangle},
+		{"Painter::draw_circle", bench_draw_circle},
+		{"Painter::draw_rounded_rect", bench_draw_rounded_rectangle},
+		{"end_calculate_size (px)", bench_end_calculate_size_px},
+		{"end_calculate_size (fit)", bench_end_calculate_size_fit},
+	};
+
+	printf("%u samples per benchmark, median first\n", SAMPLE_COUNT);
+	for (const MicroBench& it : benches)
+	{
+		if (strstr(it.name, "sse42") && !lgui::hash_sse42_supported())
+		{
+			continue;
+		}
+		if (strstr(it.name, filter))
+		{
+			run_bench(it);
+		}
+	}
+
+	lgui::deinit();
+	return 0;
+}
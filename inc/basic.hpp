@@ -14,6 +14,8 @@ inline void __lgui_assert()
 
 #define _LGUI_MACRO_STRING(a) #a
 #define LGUI_MACRO_STRING(a) _LGUI_MACRO_STRING(a)
+#define _LGUI_MACRO_CONCAT(a, b) a##b
+#define LGUI_MACRO_CONCAT(a, b) _LGUI_MACRO_CONCAT(a, b)
 #define LGUI_ASSERT(condition, message) do { if (!(condition)) { printf(__FILE__ "," LGUI_MACRO_STRING(__LINE__) ": " message "\n"); __lgui_assert(); abort(); } } while (0)
 #define LGUI_TRAP(message) do { printf(__FILE__ "," LGUI_MACRO_STRING(__LINE__) ": " message "\n"); __lgui_assert(); abort(); } while (0)
 #define LGUI_UNREACHABLE LGUI_TRAP("Unreachable")
@@ -21,6 +23,7 @@ inline void __lgui_assert()
 #define LGUI_MAX(a, b) (((a) > (b)) ? (a) : (b))
 #define LGUI_CLAMP(min, max, v) (LGUI_MAX(min, LGUI_MIN(max, v)))
 #define LGUI_ABS(v) (((v) < 0) ? -(v) : (v))
+#define LGUI_ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
 #define LGUI_KB(v) ((v) * 1024)
 #define LGUI_MB(v) (LGUI_KB(v) * 1024)
 #define LGUI_GB(v) (LGUI_GB(v) * 1024)
@@ -181,6 +184,9 @@ struct Slice {
 	T* end() { return ptr + length; }
 };
 
+// Alignment for data that is accessed in hot loops, so it never straddles two cache lines
+const usize CACHE_LINE_SIZE = 64;
+
 struct Arena;
 
 // Marker that automatically returns its arena to the point where the marker was created (using RAII)
@@ -191,12 +197,27 @@ struct ArenaMarker {
 	~ArenaMarker();
 };
 
+// Granularity in which virtual memory arenas commit and decommit pages
+const usize ARENA_COMMIT_SIZE = 256 * 1024;
+// Transparent huge page size on x64 Linux, also the commit granularity of huge page arenas
+const usize HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
 // Simple arena allocator
 // Any allocation (except raw) is initialized to 0 (ZII)
+// Raw allocations are for objects whose every field is written right away, DEBUG builds fill them with 0xCD to find the fields that are not
+// Either uses a fixed block of memory, or reserves address space and commits pages when they are needed
 struct Arena {
 	byte* ptr;
-	usize length;
+	usize length; // Usable (committed) size
 	usize used;
+	// Highest value of used since creation
+	usize high_water;
+	// Highest value of used since the last trim()
+	usize recent_high_water;
+	// Reserved address space, 0 if the arena uses fixed memory and cannot grow
+	usize reserved;
+	// Granularity of grow() and trim()
+	usize commit_size;
 
 	static Arena from_memory(void* ptr, usize size)
 	{
@@ -206,40 +227,69 @@ struct Arena {
 		return ret;
 	}
 
+	// Implemented per platform in virtual_memory.cpp
+	// Reserves the address space and commits initial_size bytes
+	// huge_pages aligns the memory to HUGE_PAGE_SIZE and advises transparent huge pages (only on Linux)
+	static Arena reserve(usize reserve_size, usize initial_size, bool huge_pages = false);
+	// Frees the memory of a reserved arena
+	void release();
+	// Commits pages until at least size bytes are usable, returns false when the reserved space is not large enough
+	bool grow(usize size);
+	// Decommits the pages above the highest usage since the last trim
+	void trim();
+
 	void reset()
 	{
 		used = 0;
 	}
 
-	// TODO: Alignment
-	void* allocate_raw(usize size)
+	// Alignment must be a power of two, it applies to the address and not to the offset in the arena
+	void* allocate_raw(usize size, usize alignment = 1)
 	{
-		LGUI_ASSERT(used + size <= length, "Out of memory");
-		void* ret = (void*)(ptr + used);
-		used += size;
+		LGUI_ASSERT((alignment & (alignment - 1)) == 0, "Alignment must be a power of two");
+		usize padding = (usize)(-(intptr_t)(ptr + used)) & (alignment - 1);
+		if (used + padding + size > length && !grow(used + padding + size))
+		{
+			LGUI_ASSERT(false, "Out of memory");
+		}
+		void* ret = (void*)(ptr + used + padding);
+		used += padding + size;
+		high_water = LGUI_MAX(high_water, used);
+		recent_high_water = LGUI_MAX(recent_high_water, used);
+#ifdef DEBUG
+		memset(ret, 0xCD, size);
+#endif
 		return ret;
 	}
 
-	// TODO: Alignment
-	void* allocate(usize size)
+	void* allocate(usize size, usize alignment = 1)
 	{
-		LGUI_ASSERT(used + size <= length, "Out of memory");
-		void* ret = (void*)(ptr + used);
+		void* ret = allocate_raw(size, alignment);
 		memset(ret, 0, size);
-		used += size;
 		return ret;
 	}
 
+	// Aligned to alignof(T) by default, use a larger alignment (16/32/64, see CACHE_LINE_SIZE) for SIMD loads
 	template<typename T>
-	Slice<T> allocate_array(usize count)
+	Slice<T> allocate_array(usize count, usize alignment = alignof(T))
 	{
-		return Slice<T>{(T*)allocate(count * sizeof(T)), count};
+		LGUI_ASSERT(alignment >= alignof(T), "Alignment is smaller than the alignment of the type");
+		return Slice<T>{(T*)allocate(count * sizeof(T), alignment), count};
 	}
 
 	template<typename T>
-	T* allocate_one()
+	T* allocate_one(usize alignment = alignof(T))
 	{
-		return (T*)allocate(sizeof(T));
+		LGUI_ASSERT(alignment >= alignof(T), "Alignment is smaller than the alignment of the type");
+		return (T*)allocate(sizeof(T), alignment);
+	}
+
+	// Not initialized, see allocate_raw
+	template<typename T>
+	T* allocate_one_raw(usize alignment = alignof(T))
+	{
+		LGUI_ASSERT(alignment >= alignof(T), "Alignment is smaller than the alignment of the type");
+		return (T*)allocate_raw(sizeof(T), alignment);
 	}
 
 	ArenaMarker make_marker()
@@ -248,6 +298,395 @@ struct Arena {
 	}
 };
 
+// Free list on top of an arena for objects of a single type, freed objects are reused before the arena grows
+// Next is the pointer member that links the free list, the object can use it for anything while it is alive
+// Reused objects are initialized to 0 like any other arena allocation (ZII)
+template<typename T, T* T::*Next>
+struct Pool {
+	T* first_free;
+	// Objects allocated from the arena, memory is never given back to it
+	u32 created;
+
+	T* allocate(Arena* arena)
+	{
+		if (first_free)
+		{
+			T* ret = first_free;
+			first_free = ret->*Next;
+			memset((void*)ret, 0, sizeof(T));
+			return ret;
+		}
+
+		++created;
+		return arena->allocate_one<T>();
+	}
+
+	// Not initialized, the caller must write every field
+	T* allocate_raw(Arena* arena)
+	{
+		if (first_free)
+		{
+			T* ret = first_free;
+			first_free = ret->*Next;
+#ifdef DEBUG
+			memset((void*)ret, 0xCD, sizeof(T));
+#endif
+			return ret;
+		}
+
+		++created;
+		return arena->allocate_one_raw<T>();
+	}
+
+	void free(T* object)
+	{
+		object->*Next = first_free;
+		first_free = object;
+	}
+
+	// Frees a list that is already linked through Next, from first up to and including last
+	void free_list(T* first, T* last)
+	{
+		last->*Next = first_free;
+		first_free = first;
+	}
+};
+
+// Reference to an object in a HandleStore, stays valid while the store moves its objects
+// The zero handle never refers to an object (ZII), generations start at 1
+struct Handle {
+	u32 index;
+	u32 generation;
+};
+
+const u32 HANDLE_STORE_NONE = 0xFFFFFFFF;
+
+// Store for long lived objects that are referenced with handles (index + generation) instead of pointers
+// Destroyed objects leave a hole until compact() moves the live objects down, the memory above them can then be given back
+// Every array reserves its own address space, pointers from get() are only valid until the next compact()
+template<typename T>
+struct HandleStore {
+	// Slots never move, they map a handle to the current position of its object
+	struct Slot {
+		u32 generation; // Incremented when the object is destroyed, so older handles don't match anymore
+		u32 position; // Position of the object, or the next free slot
+	};
+
+	Arena slots;
+	Arena objects;
+	Arena owners; // Slot of the object at every position, HANDLE_STORE_NONE for holes
+	u32 slot_count;
+	u32 object_count; // Including the holes
+	u32 hole_count;
+	u32 first_free_slot;
+
+	void init(u32 max_objects)
+	{
+		slots = Arena::reserve(sizeof(Slot) * max_objects, 0);
+		objects = Arena::reserve(sizeof(T) * max_objects, 0);
+		owners = Arena::reserve(sizeof(u32) * max_objects, 0);
+		first_free_slot = HANDLE_STORE_NONE;
+	}
+
+	void release()
+	{
+		slots.release();
+		objects.release();
+		owners.release();
+		*this = {};
+	}
+
+	// The object is initialized to 0 (ZII)
+	Handle create()
+	{
+		u32 index = first_free_slot;
+		if (index != HANDLE_STORE_NONE)
+		{
+			first_free_slot = ((Slot*)slots.ptr)[index].position;
+		}
+		else
+		{
+			index = slot_count++;
+			slots.allocate_one<Slot>()->generation = 1;
+		}
+
+		Slot& slot = ((Slot*)slots.ptr)[index];
+		slot.position = object_count++;
+		objects.allocate_one<T>();
+		*owners.allocate_one_raw<u32>() = index;
+		return {index, slot.generation};
+	}
+
+	// Null if the object has been destroyed
+	T* get(Handle handle)
+	{
+		if (handle.index >= slot_count)
+		{
+			return nullptr;
+		}
+		const Slot& slot = ((Slot*)slots.ptr)[handle.index];
+		return slot.generation == handle.generation ? (T*)objects.ptr + slot.position : nullptr;
+	}
+
+	void destroy(Handle handle)
+	{
+		LGUI_ASSERT(get(handle), "Handle does not refer to an object");
+		Slot& slot = ((Slot*)slots.ptr)[handle.index];
+		((u32*)owners.ptr)[slot.position] = HANDLE_STORE_NONE;
+		++hole_count;
+
+		slot.generation = slot.generation + 1 ? slot.generation + 1 : 1;
+		slot.position = first_free_slot;
+		first_free_slot = handle.index;
+	}
+
+	// Moves the live objects over the holes, keeping their order
+	void compact()
+	{
+		T* object_array = (T*)objects.ptr;
+		u32* owner_array = (u32*)owners.ptr;
+		u32 live_count = 0;
+		for (u32 i = 0; i < object_count; ++i)
+		{
+			u32 owner = owner_array[i];
+			if (owner == HANDLE_STORE_NONE)
+			{
+				continue;
+			}
+			if (live_count != i)
+			{
+				memcpy((void*)(object_array + live_count), (void*)(object_array + i), sizeof(T));
+				owner_array[live_count] = owner;
+				((Slot*)slots.ptr)[owner].position = live_count;
+			}
+			++live_count;
+		}
+
+		object_count = live_count;
+		hole_count = 0;
+		objects.used = live_count * sizeof(T);
+		owners.used = live_count * sizeof(u32);
+	}
+
+	// Gives the pages above the objects back, after compact() this is the memory of the destroyed objects
+	void trim()
+	{
+		slots.trim();
+		objects.trim();
+		owners.trim();
+	}
+};
+
+// Power of two sized blocks from an arena with a free list per size, for arrays that are replaced by a larger or smaller copy
+// Freed blocks are reused by any array of the same size class, the memory is never given back to the arena
+struct BlockAllocator {
+	static const u32 MIN_SIZE_LOG2 = 6; // One cache line
+	static const u32 CLASS_COUNT = 32;
+
+	Arena* arena;
+	void* first_free[CLASS_COUNT]; // Linked through the start of the blocks
+	usize allocated; // Bytes taken from the arena
+	usize free_bytes; // Bytes of the allocated blocks that are in the free lists
+
+	static u32 size_class(usize size)
+	{
+		u32 ret = 0;
+		while (((usize)1 << (ret + MIN_SIZE_LOG2)) < size)
+		{
+			++ret;
+		}
+		return ret;
+	}
+
+	// Initialized to 0 (ZII)
+	void* allocate(usize size)
+	{
+		u32 index = size_class(size);
+		usize block_size = (usize)1 << (index + MIN_SIZE_LOG2);
+		void* ret = first_free[index];
+		if (ret)
+		{
+			first_free[index] = *(void**)ret;
+			free_bytes -= block_size;
+		}
+		else
+		{
+			ret = arena->allocate_raw(block_size, CACHE_LINE_SIZE);
+			allocated += block_size;
+		}
+		memset(ret, 0, size);
+		return ret;
+	}
+
+	// Size is the one that was passed to allocate()
+	void free(void* block, usize size)
+	{
+		u32 index = size_class(size);
+		*(void**)block = first_free[index];
+		first_free[index] = block;
+		free_bytes += (usize)1 << (index + MIN_SIZE_LOG2);
+	}
+};
+
+// Index returned by HashMap::find_index() for a missing key
+const u32 HASH_MAP_NONE = 0xFFFFFFFF;
+
+// Open addressing hash map (linear probing) from well mixed u32 keys (IDs) to small values, stored in one array
+// Grows to twice the size above 3/4 load and shrink() halves it below 1/8
+// erase_at() shifts the following entries back instead of leaving tombstones, so an entry can move into the erased slot
+// Set the allocator before the first insert, the map is empty until then (ZII)
+template<typename V>
+struct HashMap {
+	struct Entry {
+		V value;
+		u32 key;
+		bool used;
+	};
+
+	static const u32 MIN_CAPACITY = 8;
+
+	BlockAllocator* allocator;
+	Entry* entries;
+	u32 capacity; // Power of two, 0 before the first insert
+	u32 count;
+	u32 shift; // 32 - log2(capacity)
+
+	// Fibonacci hashing, so keys made from small integers don't cluster
+	u32 home(u32 key) const
+	{
+		return (key * 2654435769u) >> shift;
+	}
+
+	u32 find_index(u32 key) const
+	{
+		if (!capacity)
+		{
+			return HASH_MAP_NONE;
+		}
+		for (u32 i = home(key);; i = (i + 1) & (capacity - 1))
+		{
+			const Entry& entry = entries[i];
+			if (!entry.used)
+			{
+				return HASH_MAP_NONE;
+			}
+			if (entry.key == key)
+			{
+				return i;
+			}
+		}
+	}
+
+	V* find(u32 key)
+	{
+		u32 index = find_index(key);
+		return index != HASH_MAP_NONE ? &entries[index].value : nullptr;
+	}
+
+	// The value of a new key is initialized to 0 (ZII)
+	V* insert(u32 key)
+	{
+		if ((count + 1) * 4 > capacity * 3)
+		{
+			resize(capacity ? capacity * 2 : MIN_CAPACITY);
+		}
+
+		u32 i = home(key);
+		while (entries[i].used && entries[i].key != key)
+		{
+			i = (i + 1) & (capacity - 1);
+		}
+
+		Entry& entry = entries[i];
+		if (!entry.used)
+		{
+			entry.used = true;
+			entry.key = key;
+			entry.value = {};
+			++count;
+		}
+		return &entry.value;
+	}
+
+	bool erase(u32 key)
+	{
+		u32 index = find_index(key);
+		if (index == HASH_MAP_NONE)
+		{
+			return false;
+		}
+		erase_at(index);
+		return true;
+	}
+
+	void erase_at(u32 index)
+	{
+		LGUI_ASSERT(index < capacity && entries[index].used, "No entry at this index");
+		u32 mask = capacity - 1;
+		u32 hole = index;
+		for (u32 i = (hole + 1) & mask; entries[i].used; i = (i + 1) & mask)
+		{
+			// Entries whose home is cyclically after the hole stay, the others move into it
+			u32 entry_home = home(entries[i].key);
+			bool stays = hole <= i ? (hole < entry_home && entry_home <= i) : (hole < entry_home || entry_home <= i);
+			if (!stays)
+			{
+				entries[hole] = entries[i];
+				hole = i;
+			}
+		}
+		entries[hole].used = false;
+		--count;
+	}
+
+	void shrink()
+	{
+		if (capacity > MIN_CAPACITY && count * 8 < capacity)
+		{
+			resize(capacity / 2);
+		}
+	}
+
+	void resize(u32 new_capacity)
+	{
+		LGUI_ASSERT((new_capacity & (new_capacity - 1)) == 0 && new_capacity * 3 >= count * 4, "Invalid hash map capacity");
+		Entry* old_entries = entries;
+		u32 old_capacity = capacity;
+
+		entries = (Entry*)allocator->allocate(sizeof(Entry) * new_capacity);
+		capacity = new_capacity;
+		count = 0;
+		shift = 32;
+		for (u32 it = new_capacity; it > 1; it >>= 1)
+		{
+			--shift;
+		}
+
+		for (u32 i = 0; i < old_capacity; ++i)
+		{
+			if (old_entries[i].used)
+			{
+				*insert(old_entries[i].key) = old_entries[i].value;
+			}
+		}
+		if (old_entries)
+		{
+			allocator->free(old_entries, sizeof(Entry) * old_capacity);
+		}
+	}
+
+	void release()
+	{
+		if (entries)
+		{
+			allocator->free(entries, sizeof(Entry) * capacity);
+		}
+		BlockAllocator* keep = allocator;
+		*this = {};
+		allocator = keep;
+	}
+};
+
 inline ArenaMarker::~ArenaMarker()
 {
 	LGUI_ASSERT(arena->used >= used, "Improper usage of marker (returned to higher value than current)");
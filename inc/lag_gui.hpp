@@ -1,5 +1,6 @@
 #pragma once
 #include "basic.hpp"
+#include <type_traits>
 
 // TEMP
 #include "raylib.h"
@@ -146,10 +147,10 @@ struct Rect {
 
 using ID = u32;
 
+// Lives in Context::retained_data_store, pointers to it are only valid until the next begin_frame (which compacts the store)
 struct RetainedData {
-	RetainedData* next;
-	RetainedData* prev;
 	ID id;
+	u32 frame_last_used; // Entries that are not used for a while are evicted, see InitOptions::retained_data_max_age
 
 	// Animation
 	f32 hover_t;
@@ -197,6 +198,21 @@ struct Context;
 const u64 DRAW_INDEX_MAX = 1 << 16;
 using DrawIndex = u16;
 
+const usize VERTEX_SIZE_BYTES = sizeof(f32) * 4 + sizeof(u32);
+const usize VERTEX_SIZE_FLOATS = 5;
+
+// Draw statistics, kept per painter and for the whole frame
+struct DrawStats {
+	u32 vertices;
+	u32 triangles;
+	u32 commands;
+	u32 clip_rect_pushes;
+	u32 draw_calls; // Issued by rl_render
+	u32 dropped_draws; // Shapes and text that didn't fit in the draw buffer
+
+	void add_command(const DrawCommand* command);
+};
+
 struct DrawBuffer {
 	f32* vertex_buffer;
 	usize vertex_buffer_length;
@@ -205,6 +221,10 @@ struct DrawBuffer {
 	usize index_buffer_length;
 	usize index_buffer_top;
 
+	// Totals of all painters
+	DrawStats stats; // Current frame
+	DrawStats prev_stats; // Last completed frame, including rl_render
+
 	void allocate();
 };
 
@@ -235,6 +255,26 @@ struct Font {
 	usize find_text_width_fit(const char* text, usize length, f32 spacing, f32 max_width) const;
 };
 
+// Label text shared across frames, so the labels that don't change are not copied every frame
+const usize INTERNED_STRING_CAPACITY = 64; // Longer text is copied to the temporary arena instead
+// Every interned string is checked for eviction once in this many frames
+const u32 INTERNED_STRING_SWEEP_FRAMES = 16;
+// Frames a string is kept after its last use, must be at least 2 because boxes of the previous frame still point to it
+const u32 INTERNED_STRING_MAX_AGE = 8;
+
+struct InternedString {
+	InternedString* next; // Other strings with the same hash (or free list)
+	u32 hash;
+	u32 length;
+	u32 frame_last_used;
+
+	// Cached metrics
+	f32 width;
+	const Font* width_font; // Font the width was measured with
+
+	char text[INTERNED_STRING_CAPACITY];
+};
+
 struct Icon {
 	Icon* next;
 
@@ -266,7 +306,8 @@ struct Atlas {
 
 	Font* add_font(const char* filename, f32 pixel_height);
 	Icon* add_icon(const char* name, byte* pixels_rgba, u32 width, u32 height);
-	bool build();
+	// Set upload_texture to false to only generate glyph data (when there is no graphics context)
+	bool build(bool upload_texture = true);
 };
 
 struct Style {
@@ -359,6 +400,33 @@ enum BoxFlags {
 	BoxFlag_AnyDrawFlags = BoxFlag_DrawRectangle | BoxFlag_DrawCircle | BoxFlag_DrawText | BoxFlag_DrawHook,
 };
 
+// Styling, drawing and animation of a box
+// Stored apart from the box, so the layout passes touch fewer cache lines per box
+struct BoxDrawData {
+	DrawHook draw_hook;
+	void* draw_user_data;
+
+	// Styling
+	Color color;
+	Color outline_color;
+	Color text_color;
+	f32 outline_size;
+	const char* text;
+	usize text_length;
+	f32 text_width; // 0 when not measured yet
+	Font* font;
+
+	// Animation
+	f32 hover_t;
+	f32 active_t;
+
+	// Layout heat map, only measured while it is enabled
+	u64 heat_start_ns;
+	u32 heat_layout_ns; // Building and sizing this box and its children
+	u32 heat_draw_ns; // _draw_box of this box and its children
+	u32 descendant_count;
+};
+
 struct Box {
 	Box* parent;
 	Box* next;
@@ -372,7 +440,8 @@ struct Box {
 
 	Box* next_unknown_size[2];
 
-	Box* hash_next;
+	// Box allocated before this one in the panel, for building the lookup table of the frame
+	Box* prev_allocated;
 
 	ID id;
 	u32 flags;
@@ -412,21 +481,8 @@ struct Box {
 	// Value added to the final position of the children of this box
 	v2 offset;
 
-	DrawHook draw_hook;
-	void* draw_user_data;
-
-	// Styling
-	Color color;
-	Color outline_color;
-	Color text_color;
-	f32 outline_size;
-	const char* text;
-	usize text_length;
-	Font* font;
-
-	// Animation
-	f32 hover_t;
-	f32 active_t;
+	// Null until get_draw_data() is called, boxes that only do layout never allocate it
+	BoxDrawData* draw_data;
 
 	// Adds the child box to the tree
 	void append_child(Box* box);
@@ -448,6 +504,9 @@ struct Box {
 
 	Rect prev_rect() { return Rect::from_pos_size(calculated_position, calculated_size); }
 
+	// Allocates the draw data in the temporary arena on first use
+	BoxDrawData* get_draw_data();
+
 	void set_rectangle(Color color);
 	void set_rectangle(Color color, Color outline_color, f32 outline_size);
 	void set_circle(Color color);
@@ -477,6 +536,12 @@ struct Painter {
 
 	u32 frame_last_updated;
 
+	DrawStats stats; // Current frame
+	DrawStats prev_stats; // Last frame the painter was used, including rl_render
+
+	// Stats of the last completed frame, whether or not the painter was started this frame
+	const DrawStats& get_completed_stats();
+
 	Rect clip_rect_stack[MAX_CLIP_RECT];
 	u32 clip_rect_stack_top;
 
@@ -485,6 +550,8 @@ struct Painter {
 	// Call when returning to a previous panel
 	void _restart_painter();
 	void _push_command();
+	// Returns the commands of the last frame the painter was used in to the pool
+	void _free_commands();
 
 	void push_clip_rect(Rect rect);
 	void pop_clip_rect();
@@ -764,11 +831,61 @@ enum {
 	PanelFlag_BeginClosed = 1 << 16,
 };
 
-//const usize RETAINED_TABLE_SIZE = 16;
-const usize RETAINED_TABLE_SIZE = 256;
-//const usize BOX_TABLE_SIZE = 64;
-const usize BOX_TABLE_SIZE = 512;
+// Object types tracked by the allocation statistics
+enum AllocationType {
+	AllocationType_Box,
+	AllocationType_DrawCommand,
+	AllocationType_RetainedData,
+	AllocationType_Panel,
+	AllocationType_String, // Copied strings (labels)
+	AllocationType_BoxLookup, // Box hash tables of the panels
+	AllocationType_BoxDrawData,
+	AllocationType_InternedString, // New strings in the interned string table
+	AllocationType_COUNT,
+};
+
+struct AllocationCounter {
+	u32 count;
+	usize bytes;
+};
+
+// Allocations made while a panel is on top of the panel stack
+struct PanelMemoryStats {
+	AllocationCounter frame[AllocationType_COUNT]; // Current frame
+	AllocationCounter prev_frame[AllocationType_COUNT]; // Last completed frame the panel was updated in
+
+	// Retained data is only freed together with the panel or by the eviction, so a count that keeps growing is a leak
+	u32 retained_data_count;
+	u32 retained_data_frame_grown; // Last frame a new node was allocated
+	u32 retained_data_evicted; // Total since the panel was created
+};
+
+// Smallest box lookup table, it is sized from the box count of the previous frame
+const u32 BOX_LOOKUP_MIN_CAPACITY = 16;
 const usize PANEL_NAME_SIZE = 16;
+// One more than the number of scratch arenas a function can hold at once (its own and the one of the caller)
+const usize SCRATCH_ARENA_COUNT = 2;
+// Every retained data entry of a panel is checked for eviction once in this many frames
+const u32 RETAINED_SWEEP_FRAMES = 32;
+// Default for InitOptions::retained_data_max
+const u32 RETAINED_DATA_MAX = 1 << 20;
+
+struct BoxLookupSlot {
+	Box* box; // nullptr if the slot is empty
+	ID id;
+};
+
+// Boxes a panel allocated in one frame
+// The open addressing table (linear probing) is only built in the next frame, the first time a box isn't the expected one
+// So frames with the same boxes in the same order never pay for it
+struct BoxLookup {
+	Box* last_allocated; // Linked through Box::prev_allocated
+	u32 box_count;
+
+	BoxLookupSlot* slots; // Allocated in the temporary arena of the frame that builds it
+	u32 capacity; // Power of two, at least twice the box count
+	u32 shift; // 32 - log2(capacity), for the multiplicative hash
+};
 
 struct Panel {
 	PanelFlag flags;
@@ -782,10 +899,6 @@ struct Panel {
 	Panel* order_next; // Towards the screen
 	Panel* order_prev;
 
-	// General list
-	Panel* hash_next;
-	Panel* hash_prev;
-
 	// Docking
 	Dock* parent_dock; // Actually the root dock if this is the root panel
 	Panel* next_dock_tab;
@@ -794,12 +907,13 @@ struct Panel {
 	bool is_dock_root;
 	bool is_docked() const { return parent_dock; }
 
-	// Retained data of contained elements
-	RetainedData* retained_data_lookup[RETAINED_TABLE_SIZE];
+	// Retained data of contained elements, grows with the number of stateful widgets
+	HashMap<Handle> retained_data_lookup;
+	u32 retained_sweep_index; // Next entry checked for unused retained data
 
 	// Boxs from previous and current frame
 	// Swap between these two every frame
-	Box** box_lookup[2];
+	BoxLookup box_lookup[2];
 
 	Box* first_unknown_fit[2];
 	Box* last_unknown_fit[2];
@@ -821,13 +935,81 @@ struct Panel {
 	v2 anchor_point_pos;
 	i8 anchor_point_h_align;
 	i8 anchor_point_v_align;
+
+	PanelMemoryStats memory_stats;
+};
+
+struct MemoryStats {
+	// Allocations per object type
+	AllocationCounter frame[AllocationType_COUNT]; // Current frame
+	AllocationCounter prev_frame[AllocationType_COUNT]; // Last completed frame
+	AllocationCounter total[AllocationType_COUNT]; // Since init
+
+	// Bytes used by each temporary arena at the end of the last frame it was used in
+	usize temp_arena_frame_used[2];
+};
+
+#ifdef LGUI_PROFILER
+// A begin or end marker of a profiler zone
+struct ProfileMarker {
+	const char* name;
+	u64 time_ns;
+	bool is_end;
+};
+
+// Maximum amount of markers per frame, older markers are overwritten when the buffer is full
+const usize PROFILE_MARKER_MAX = 8192;
+
+struct Profiler {
+	bool enabled;
+
+	// Ring buffer of the current frame (allocated in the temporary arena)
+	ProfileMarker* markers;
+	u32 marker_count; // Total amount of markers written this frame, can be more than PROFILE_MARKER_MAX
+	u64 frame_start_ns;
+
+	// Last completed frame, still valid because the temporary arena is only cleared every other frame
+	ProfileMarker* prev_markers;
+	u32 prev_marker_count;
+	u64 prev_frame_start_ns;
+	u64 prev_frame_end_ns;
+};
+#endif
+
+enum InputRecordMode {
+	InputRecordMode_None,
+	InputRecordMode_Record,
+	InputRecordMode_Replay,
+};
+
+struct InputRecorder {
+	InputRecordMode mode;
+	void* file; // FILE*
+	u32 frame_count; // Frames written or read so far
+
+	// Key state as last written to or read from the file, only changes are stored
+	bool keys_down[Key::MAX];
+};
+
+const usize WATCHDOG_PATH_SIZE = 128;
+
+struct FrameWatchdog {
+	u64 budget_ns; // 0 if disabled
+	char path_prefix[WATCHDOG_PATH_SIZE];
+	u32 max_captures; // 0 is unlimited
+	u32 capture_count;
+
+	u64 frame_start_ns;
+	u64 last_frame_ns; // begin_frame to end_frame of the last completed frame
+	// Frame that went over the budget, it is written at the start of the next begin_frame when its profiler zones are complete
+	u32 pending_frame;
+	u64 pending_frame_ns;
 };
 
 const usize ID_STACK_SIZE = 32;
 const usize PANEL_STACK_SIZE = 32;
 const usize STYLE_STACK_SIZE = 32;
 const usize BOX_STACK_SIZE = 32;
-const usize PANEL_MAP_SIZE = 32;
 const usize INPUT_CODEPOINT_MAX = 8;
 
 struct Context {
@@ -873,11 +1055,25 @@ struct Context {
 	// Cleared every other frame (swaps between them every frame
 	Arena* temp_arena;
 	Arena temp_arena_arr[2];
-
-	// Stored in main arena
-	Panel* first_free_panel;
-	RetainedData* first_free_retained_data;
-	DrawCommand* first_free_draw_command;
+	// Used for temporary work inside functions, see get_scratch
+	Arena scratch_arenas[SCRATCH_ARENA_COUNT];
+
+	// Free lists of objects in the main arena
+	Pool<Panel, &Panel::order_next> panel_pool;
+	Pool<Dock, &Dock::next_root> dock_pool; // The root list is cleared every frame, so freed docks can use it
+	Pool<DrawCommand, &DrawCommand::next> draw_command_pool;
+	Pool<InternedString, &InternedString::next> interned_string_pool;
+	// Arrays of the hash maps (panel map and retained data lookups)
+	BlockAllocator hash_map_blocks;
+
+	// Compacted in begin_frame once enough of it has been freed
+	HandleStore<RetainedData> retained_data_store;
+
+	// Interned label text
+	// Maps the hash to the strings with that hash, grows with the number of distinct labels
+	HashMap<InternedString*> interned_strings;
+	u32 interned_string_count;
+	u32 interned_sweep_index; // Next entry checked for unused strings
 
 	DrawBuffer draw_buffer;
 	DrawBuffer merge_draw_buffer;
@@ -893,8 +1089,8 @@ struct Context {
 	Box* box_next_expected;
 
 	// Panel lookup
-	// Maps ID to panel
-	Panel* panel_map[PANEL_MAP_SIZE];
+	// Maps ID to panel, iterate the entries for all panels
+	HashMap<Panel*> panel_map;
 
 	// Atlas
 	Atlas atlas;
@@ -903,16 +1099,74 @@ struct Context {
 	Codepoint codepoints_pressed[INPUT_CODEPOINT_MAX];
 	usize codepoints_pressed_length;
 	u8 keys[Key::MAX];
+
+	MemoryStats memory_stats;
+	InputRecorder input_recorder;
+	FrameWatchdog frame_watchdog;
+	u32 temp_arena_trim_interval;
+	u32 retained_data_max_age;
+
+	bool layout_heat_map_enabled;
+	bool layout_heat_map_active; // Enabled state for the current frame
+
+#ifdef LGUI_PROFILER
+	Profiler profiler;
+#endif
 };
 
+// Registers an allocation in the memory statistics
+inline void _track_allocation(Context* context, AllocationType type, usize size)
+{
+	AllocationCounter& frame = context->memory_stats.frame[type];
+	AllocationCounter& total = context->memory_stats.total[type];
+	frame.count += 1;
+	frame.bytes += size;
+	total.count += 1;
+	total.bytes += size;
+
+	if (context->panel_top)
+	{
+		AllocationCounter& panel_frame = context->panel_top->memory_stats.frame[type];
+		panel_frame.count += 1;
+		panel_frame.bytes += size;
+	}
+}
+
 
 
 // Core
 
+struct InitOptions {
+	// Size of every arena (the persistent one, the two temporary ones and the scratch arenas)
+	usize arena_size_mb;
+	// If not 0, every arena reserves this much address space instead and commits pages when they are first needed
+	// arena_size_mb is then the initially committed size, and the arenas grow instead of running out of memory
+	usize arena_reserve_mb;
+	// Size of each scratch arena (or its reserved address space with arena_reserve_mb), 0 uses the sizes above
+	// Scratch arenas only hold data inside a single function, like the font files while building the atlas
+	usize scratch_arena_size_mb;
+	// Frames between giving back the temporary and scratch arena pages above their high water mark of that period, 0 never does
+	u32 temp_arena_trim_interval;
+	// Retained data that has not been used for this many frames is freed, 0 keeps it as long as its panel exists
+	// Keep it large enough for state that must survive while hidden (closed tree nodes, other dock tabs)
+	u32 retained_data_max_age;
+	// Most retained data entries alive at once over all panels, only address space is reserved for them
+	// 0 uses RETAINED_DATA_MAX
+	u32 retained_data_max;
+	// Aligns the arenas to 2 MB and advises transparent huge pages, to reduce TLB misses (Linux only)
+	// Also applies to fixed size arenas, they are then mapped instead of allocated with malloc
+	bool huge_pages;
+};
+
+// Uses fixed arenas of arena_size_mb
 Context* init(usize arena_size_mb = 8);
+Context* init(const InitOptions& options);
 void deinit();
 Context* get_context();
+// Reads mouse input from Raylib
 void begin_frame(f32 delta_time);
+// Uses the provided mouse input instead (for headless usage, like benchmarks)
+void begin_frame(f32 delta_time, const MouseState& mouse_state);
 void end_frame();
 void draw_frame();
 
@@ -920,12 +1174,130 @@ void draw_frame();
 // To check if any ui is hovered over with the mouse
 bool is_anything_hovered();
 
+// Monotonic time in nanoseconds
+u64 get_time_ns();
+
+// Scratch arena for temporary allocations inside a function, the returned marker resets it when it goes out of scope
+// Pass the arena the function allocates its results in when that can be a scratch arena (a caller's scratch), a different one is returned then
+// Results that outlive the function belong in the temporary arena instead
+ArenaMarker get_scratch(Arena* conflict = nullptr);
+
+// Allocation statistics, use this to size the arenas passed to init()
+const MemoryStats& get_memory_stats();
+// Returns nullptr if there is no panel with this name
+const PanelMemoryStats* get_panel_memory_stats(const char* name);
+
+
+// Hash of the IDs and the interned strings, the policy is chosen at build time
+// Default is the table CRC32 (xcrc32), LGUI_HASH_SSE42 uses the crc32 instruction and LGUI_HASH_FAST a 64-bit multiply/xorshift mix
+u32 hash_bytes(const byte* data, usize length, u32 seed);
+// The policies on their own, for the benchmarks
+u32 hash_crc32_table(const byte* data, usize length, u32 seed);
+u32 hash_crc32_sse42(const byte* data, usize length, u32 seed); // Only call it if hash_sse42_supported()
+u32 hash_fast64(const byte* data, usize length, u32 seed);
+bool hash_sse42_supported();
+
+// Little endian load for the compile time hashes
+constexpr u64 _hash_load_literal(const char* str, usize count)
+{
+	u64 ret = 0;
+	for (usize i = 0; i < count; ++i)
+	{
+		ret |= (u64)(u8)str[i] << (i * 8);
+	}
+	return ret;
+}
+
+// hash_bytes(str, length, 0) evaluated by the compiler, for the labels hashed at compile time
+constexpr u32 hash_literal(const char* str, usize length)
+{
+#if defined(LGUI_HASH_SSE42)
+	// CRC32C one bit at a time
+	u32 crc = ~0u;
+	for (usize i = 0; i < length; ++i)
+	{
+		crc ^= (u8)str[i];
+		for (int bit = 0; bit < 8; ++bit)
+		{
+			crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+		}
+	}
+	return ~crc;
+#elif defined(LGUI_HASH_FAST)
+	const u64 multiplier = 0x9E3779B97F4A7C15ull;
+	u64 hash = (u64)length * multiplier;
+	usize i = 0;
+	for (; i + 8 <= length; i += 8)
+	{
+		hash = (hash ^ _hash_load_literal(str + i, 8)) * multiplier;
+		hash ^= hash >> 29;
+	}
+	usize rest = length - i;
+	if (rest)
+	{
+		u64 word = rest >= 4 ?
+			_hash_load_literal(str + i + rest - 4, 4) << 32 | _hash_load_literal(str + i, 4) :
+			(u64)(u8)str[i] | (u64)(u8)str[i + rest / 2] << 8 | (u64)(u8)str[i + rest - 1] << 16;
+		hash = (hash ^ word) * multiplier;
+		hash ^= hash >> 29;
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ull;
+	hash ^= hash >> 33;
+	return (u32)hash;
+#else
+	// xcrc32 one bit at a time (polynomial 0x04c11db7, most significant bit first)
+	u32 crc = 0;
+	for (usize i = 0; i < length; ++i)
+	{
+		crc ^= (u32)(u8)str[i] << 24;
+		for (int bit = 0; bit < 8; ++bit)
+		{
+			crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04c11db7u : crc << 1;
+		}
+	}
+	return crc;
+#endif
+}
+
+// Combines a precomputed hash with a seed (the current id_top) in a single mix
+inline ID combine_id(u32 hash, ID seed)
+{
+	return (ID)((((u64)seed << 32) | hash) * 0x9E3779B97F4A7C15ull >> 32);
+}
+
+// Label hashed at compile time, create it with LGUI_ID_LIT("Save")
+struct IDLiteral {
+	const char* text;
+	usize length;
+	u32 hash;
+};
+
+// The integral_constant forces the hash to be computed by the compiler
+#define LGUI_ID_LIT(str) (lgui::IDLiteral{str, sizeof(str) - 1, std::integral_constant<lgui::u32, lgui::hash_literal(str, sizeof(str) - 1)>::value})
+
+// Text of a widget with its length and hash, so a widget scans and hashes it once
+// Strings convert to it implicitly (hashed at runtime) as do LGUI_ID_LIT labels (hashed by the compiler)
+// The hash doesn't depend on the ID stack, the width per font is cached with the interned string of the same hash
+struct Label {
+	const char* text;
+	usize length;
+	u32 hash;
+
+	Label(const char* text) : text(text), length(strlen(text)), hash(hash_bytes((const byte*)text, length, 0)) {}
+	Label(IDLiteral literal) : text(literal.text), length(literal.length), hash(literal.hash) {}
+};
 
 ID get_id(const char* string);
+ID get_id(const Label& label);
 ID get_id(i32 i);
 ID get_id(void* ptr);
 ID peek_id();
 void push_id(const char* string);
+void push_id(const Label& label);
 void push_id(i32 i);
 void push_id(void* ptr);
 void push_id_raw(ID id);
@@ -938,6 +1310,12 @@ const Style& get_style();
 void set_default_style(const Style& style);
 
 
+// Copy a string into the temporary arena (tracked in the memory statistics)
+const char* _copy_temp_string(const char* str, usize length);
+// Copy of a label that stays valid for the next frame as well, strings used recently are shared instead of copied
+// Also returns the width of the text in the font, which is cached for interned strings
+const char* _intern_string(const Label& label, const Font* font, f32* width);
+
 // Only allocate the box
 Box* _allocate_box(ID id);
 // Allocate box and add it to the parent box
@@ -972,6 +1350,9 @@ void close_panel();
 void open_panel(const char* name);
 void open_panel(ID id);
 void move_panel_to_front(Panel* panel);
+// Docks a panel into another one at the end of the frame, like dropping it on a docking target
+// Both panels must already exist, does nothing if the panel is already docked
+void dock_panel(const char* name, const char* into_name, DockEntry entry);
 // This will force the panel to be drawn at a given point
 void set_panel_anchor_point(v2 pos, i8 h_align = -1, i8 v_align = -1);
 Painter& get_painter();
@@ -1010,13 +1391,16 @@ void select_element(ID id);
 
 // Builder code
 
-InputResult button(const char* name);
-InputResult button(const char* name, Size2 size);
-InputResult checkbox(const char* name, bool* value);
-InputResult radio_button(const char* name, int option, int* selected);
-InputResult drag_value(const char* name, Size2 size, f32* value);
-InputResult slider_value(const char* name, Size2 size, f32 min, f32 max, f32* value);
-bool collapse_header(const char* name);
+InputResult button(Label name);
+InputResult button(Label name, Size2 size);
+InputResult checkbox(Label name, bool* value);
+InputResult radio_button(Label name, int option, int* selected);
+InputResult drag_value(Label name, Size2 size, f32* value);
+InputResult slider_value(Label name, Size2 size, f32 min, f32 max, f32* value);
+bool collapse_header(Label name);
+void text(Label text, bool static_string = false);
+void text(Label text, Size2 size, i8 h_align = 0, i8 v_align = 0, bool static_string = false);
+// Same as above, but a static string is drawn without hashing it
 void text(const char* text, bool static_string = false);
 void text(const char* text, Size2 size, i8 h_align = 0, i8 v_align = 0, bool static_string = false);
 void textf(const char* format, ...);
@@ -1029,17 +1413,17 @@ void min_size(f32 size);
 Box* draw_hook(Size2 size, void* ud, DrawHook hook);
 Box* draw_hook(Size2 size, DrawHook hook);
 
-bool begin_fancy_collapse_header(const char* name);
+bool begin_fancy_collapse_header(Label name);
 void end_fancy_collapse_header();
 
-bool begin_tab_bar(const char* name);
+bool begin_tab_bar(Label name);
 void end_tab_bar();
-bool do_tab(const char* name);
+bool do_tab(Label name);
 
-bool begin_tree_node(const char* name);
+bool begin_tree_node(Label name);
 void end_tree_node();
 
-bool begin_button_menu(const char* name);
+bool begin_button_menu(Label name);
 void end_button_menu();
 
 
@@ -1047,9 +1431,81 @@ void draw_open_triangle(Painter* painter, v2 pos, f32 size, f32 rotation, Color
 
 
 
+// Profiler
+// Zones are only compiled in when LGUI_PROFILER is defined, and are disabled at runtime by default
+
+#ifdef LGUI_PROFILER
+void profiler_set_enabled(bool enabled);
+bool profiler_is_enabled();
+void profiler_begin_zone(const char* name);
+void profiler_end_zone();
+// Writes the zones of the last completed frame in the Chrome trace format (chrome://tracing or ui.perfetto.dev)
+bool profiler_export_chrome_trace(const char* filename);
+// Draws the zones of the last completed frame as a flame graph
+void profiler_draw_flame_graph(Painter& painter, Rect rect);
+// Called by begin_frame
+void _profiler_begin_frame();
+// Writes the zones of the last completed frame as an indented list to a FILE*
+void _profiler_write_prev_zones(void* file);
+
+// Ends the zone when going out of scope
+struct ProfileZoneScope {
+	ProfileZoneScope(const char* name) { profiler_begin_zone(name); }
+	~ProfileZoneScope() { profiler_end_zone(); }
+};
+
+#define LGUI_PROFILE_ZONE(name) ::lgui::ProfileZoneScope LGUI_MACRO_CONCAT(_lgui_zone_, __LINE__)(name)
+#else
+#define LGUI_PROFILE_ZONE(name)
+#endif
+
+
+
+// Input recording
+// Stores the input of every frame in a binary file, so a session can be replayed headless
+// Set app_window_size before begin_frame, it is recorded with the input
+
+// Starts writing the input of every following begin_frame to the file
+bool input_record_begin(const char* filename);
+void input_record_end();
+// Opens a recording for input_replay_frame
+bool input_replay_begin(const char* filename);
+void input_replay_end();
+// Registers the input of the next recorded frame and calls begin_frame with it
+// Returns false (without starting a frame) when the recording has ended
+bool input_replay_frame();
+// Called by begin_frame
+void _input_record_frame(f32 delta_time, const MouseState& mouse_state);
+
+// Hash of the vertices, indices and draw commands of the last built frame, to compare the output of two builds
+u32 get_draw_buffer_hash();
+
+
+
+// Frame watchdog
+// When the time from begin_frame to end_frame goes over the budget, the box trees, draw commands and profiler zones
+// of that frame are written to "<path_prefix><frame>.txt"
+// Profiler zones are only included when built with LGUI_PROFILER and the profiler is enabled
+
+void frame_watchdog_begin(f32 budget_ms, const char* path_prefix, u32 max_captures = 8);
+// Writes a capture that is still pending
+void frame_watchdog_end();
+// Called by begin_frame and end_frame
+void _frame_watchdog_begin_frame();
+void _frame_watchdog_end_frame();
+
+
+
 // Debug
 
+// Times every box while building, sizing and drawing it, and tints the boxes by the cost of their subtree
+// Hovering a box shows the exact times and the amount of descendants
+void layout_heat_map_set_enabled(bool enabled);
+bool layout_heat_map_is_enabled();
+
 void debug_menu();
+// Name of the panel in debug output, dock root panels have no name and are named after the tabs of their dock instead
+const char* get_panel_debug_name(Panel* panel, char* buffer, usize buffer_size);
 // Draw rectangle and shows text when hovered
 void debug_rect(Rect rect, const char* text, Color color);
 
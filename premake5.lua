@@ -1,10 +1,46 @@
+newoption {
+	trigger = "profiler",
+	description = "Compile the profiler zones into the library (LGUI_PROFILER)"
+}
+
+newoption {
+	trigger = "hash",
+	value = "POLICY",
+	description = "Hash used for the IDs",
+	default = "table",
+	allowed = {
+		{ "table", "Table based CRC32 (default)" },
+		{ "sse42", "CRC32C with the SSE4.2 crc32 instruction" },
+		{ "fast", "64-bit multiply and xorshift mixing" },
+	}
+}
+
 workspace "LagGui"
 	configurations { "Debug", "Release" }
+	architecture "x64"
 
--- TODO: Make separate config for raylib test and library
+	filter "configurations:Debug"
+		defines { "DEBUG" }
+		symbols "On"
 
-project "LagGui"
-	kind "ConsoleApp"
+	filter "configurations:Release"
+		defines { "NDEBUG" }
+		optimize "On"
+
+	filter "options:profiler"
+		defines { "LGUI_PROFILER" }
+
+	filter "options:hash=sse42"
+		defines { "LGUI_HASH_SSE42" }
+
+	filter "options:hash=fast"
+		defines { "LGUI_HASH_FAST" }
+
+	filter {}
+
+-- The library itself (without the test application)
+project "LagGuiLib"
+	kind "StaticLib"
 	language "C++"
 	targetdir "bin/%{cfg.buildcfg}"
 
@@ -13,18 +49,65 @@ project "LagGui"
 	--flags { "FatalWarnings" }
 
 	includedirs { "./inc" }
-	files { "**.h", "**.cpp", "**.c" }
+	files { "inc/**.h", "inc/**.hpp", "src/**.cpp", "src/**.c" }
+	removefiles { "src/main.cpp", "src/test_scenes.cpp" }
+
+	includedirs { "./lib/raylib/include" }
+
+-- Raylib test application
+project "LagGui"
+	kind "ConsoleApp"
+	language "C++"
+	targetdir "bin/%{cfg.buildcfg}"
+
+	includedirs { "./inc", "./src" }
+	files { "src/main.cpp", "src/test_scenes.cpp", "src/test_scenes.hpp" }
 
 	libdirs { "lib/raylib/lib" }
 	includedirs { "./lib/raylib/include" }
-	links { "raylib", "windowsapp" }
+	links { "LagGuiLib", "raylib", "windowsapp" }
 
-    architecture "x64"
+-- Headless benchmark, runs the test scenes without opening a window
+-- Run from the repository root so the fonts can be found
+project "lgui_bench"
+	kind "ConsoleApp"
+	language "C++"
+	targetdir "bin/%{cfg.buildcfg}"
+	debugdir "."
 
-	filter "configurations:Debug"
-		defines { "DEBUG" }
-		symbols "On"
+	includedirs { "./inc", "./src" }
+	files { "bench/bench.cpp", "src/test_scenes.cpp", "src/test_scenes.hpp" }
 
-	filter "configurations:Release"
-		defines { "NDEBUG" }
-		optimize "On"
+	-- Raylib is only linked because the library still references it, no window is opened
+	libdirs { "lib/raylib/lib" }
+	includedirs { "./lib/raylib/include" }
+	links { "LagGuiLib", "raylib", "windowsapp" }
+
+-- Microbenchmarks of the hot primitives (ids, box lookup, text, painter, layout)
+project "lgui_microbench"
+	kind "ConsoleApp"
+	language "C++"
+	targetdir "bin/%{cfg.buildcfg}"
+	debugdir "."
+
+	includedirs { "./inc", "./src" }
+	files { "bench/micro_bench.cpp", "src/test_scenes.cpp", "src/test_scenes.hpp" }
+
+	libdirs { "lib/raylib/lib" }
+	includedirs { "./lib/raylib/include" }
+	links { "LagGuiLib", "raylib", "windowsapp" }
+
+-- Tests of the parts that don't need a window, exits with a nonzero code on failure
+-- Run from the repository root so the fonts can be found
+project "lgui_tests"
+	kind "ConsoleApp"
+	language "C++"
+	targetdir "bin/%{cfg.buildcfg}"
+	debugdir "."
+
+	includedirs { "./inc" }
+	files { "tests/**.cpp", "tests/**.hpp" }
+
+	libdirs { "lib/raylib/lib" }
+	includedirs { "./lib/raylib/include" }
+	links { "LagGuiLib", "raylib", "windowsapp" }
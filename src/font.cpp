@@ -88,29 +88,32 @@ struct TempFont {
 	f32 scale;
 };
 
-bool Atlas::build()
+bool Atlas::build(bool upload_texture)
 {
 	Context* context = get_context();
 
 	auto character_count = character_end - character_start;
 
-	auto nodes = context->temp_arena->allocate_array<stbrp_node>(512);
+	// Everything except the texture and glyphs is only needed while building
+	ArenaMarker scratch = get_scratch();
+
+	auto nodes = scratch.arena->allocate_array<stbrp_node>(512);
 	stbrp_context packer{};
 	stbrp_init_target(&packer, 512, 511, nodes.ptr, (int)nodes.length);
 
 	usize rects_count = rect_count(&context->atlas);
-	Slice<stbrp_rect> rects = context->temp_arena->allocate_array<stbrp_rect>(rects_count);
+	Slice<stbrp_rect> rects = scratch.arena->allocate_array<stbrp_rect>(rects_count);
 	usize rects_top = 0;
 
 	for (Font* font = context->atlas.first_font; font; font = font->next)
 	{
-		Slice<byte> file = read_file(context->temp_arena, font->name);
+		Slice<byte> file = read_file(scratch.arena, font->name);
 		if (!file.ptr)
 		{
 			continue;
 		}
 
-		TempFont* temp_font = context->temp_arena->allocate_one<TempFont>();
+		TempFont* temp_font = scratch.arena->allocate_one<TempFont>();
 		temp_font->font = font;
 		stbtt_InitFont(&temp_font->font_info, file.ptr, 0);
 
@@ -188,10 +191,15 @@ bool Atlas::build()
 	// Write white pixel
 	texture[texture.length - 1] = 255;
 
+	if (!upload_texture)
+	{
+		return true;
+	}
+
 	// TODO: Replace with non-raylib solution
 	{
 		// Convert to rgba
-		Slice<byte> texture_rgba = context->temp_arena->allocate_array<byte>(texture_width * texture_height * 4);
+		Slice<byte> texture_rgba = scratch.arena->allocate_array<byte>(texture_width * texture_height * 4);
 		for (usize i = 0; i < texture_width * texture_height; ++i)
 		{
 			usize ind = i * 4;
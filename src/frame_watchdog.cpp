@@ -0,0 +1,160 @@
+#include "lag_gui.hpp"
+#include "basic.hpp"
+#include <stdio.h>
+
+namespace lgui {
+
+void frame_watchdog_begin(f32 budget_ms, const char* path_prefix, u32 max_captures)
+{
+	FrameWatchdog& watchdog = get_context()->frame_watchdog;
+
+	watchdog = {};
+	watchdog.budget_ns = (u64)(budget_ms * 1000000.f);
+	copy_string_to_buffer(watchdog.path_prefix, WATCHDOG_PATH_SIZE, path_prefix);
+	watchdog.max_captures = max_captures;
+}
+
+static void _write_box(FILE* file, Box* box, u32 depth)
+{
+	fprintf(file, "%*s%08x flags %05x pos (%.1f, %.1f) size (%.1f, %.1f)", (int)depth * 2, "",
+		box->id, box->flags, box->calculated_position.x, box->calculated_position.y,
+		box->calculated_size.x, box->calculated_size.y);
+	if (box->draw_data && box->draw_data->text)
+	{
+		fprintf(file, " \"%.*s\"", (int)box->draw_data->text_length, box->draw_data->text);
+	}
+	fprintf(file, "\n");
+
+	for (Box* it = box->first_child; it; it = it->next)
+	{
+		_write_box(file, it, depth + 1);
+	}
+}
+
+static void _write_capture()
+{
+	Context* context = get_context();
+	FrameWatchdog& watchdog = context->frame_watchdog;
+
+	char filename[WATCHDOG_PATH_SIZE + 16];
+	snprintf(filename, sizeof(filename), "%s%u.txt", watchdog.path_prefix, watchdog.pending_frame);
+
+	FILE* file;
+	if (fopen_s(&file, filename, "wb"))
+	{
+		return;
+	}
+
+	fprintf(file, "frame %u: %.3f ms, budget %.3f ms\n", watchdog.pending_frame,
+		(f64)watchdog.pending_frame_ns / 1000000.0, (f64)watchdog.budget_ns / 1000000.0);
+
+	char name[128];
+
+	// Only the panels that were updated in the slow frame, their boxes are still in the other temporary arena
+	// The panel map also has the docked tabs, they are not in the depth list
+	fprintf(file, "\n[boxes]\n");
+	for (u32 i = 0; i < context->panel_map.capacity; ++i)
+	{
+		if (!context->panel_map.entries[i].used) continue;
+		Panel* panel = context->panel_map.entries[i].value;
+		if (panel->frame_last_updated != watchdog.pending_frame || !panel->root_box)
+		{
+			continue;
+		}
+
+		fprintf(file, "panel \"%s\" rect (%.1f, %.1f, %.1f, %.1f)\n", get_panel_debug_name(panel, name, sizeof(name)),
+			panel->rect.top_left.x, panel->rect.top_left.y, panel->rect.bottom_right.x, panel->rect.bottom_right.y);
+		_write_box(file, panel->root_box, 1);
+	}
+
+	// Docked panels share the painter of their root panel
+	fprintf(file, "\n[draw commands]\n");
+	for (u32 i = 0; i < context->panel_map.capacity; ++i)
+	{
+		if (!context->panel_map.entries[i].used) continue;
+		Panel* panel = context->panel_map.entries[i].value;
+		Painter& painter = panel->painter;
+		if (painter.frame_last_updated != watchdog.pending_frame || !painter.first_command)
+		{
+			continue;
+		}
+
+		fprintf(file, "painter \"%s\"\n", get_panel_debug_name(panel, name, sizeof(name)));
+		for (DrawCommand* it = painter.first_command; it; it = it->next)
+		{
+			fprintf(file, "  texture %u clip (%.1f, %.1f, %.1f, %.1f) vertices %zu indices %zu (first index %zu)\n",
+				it->texture_id, it->clip_rect.top_left.x, it->clip_rect.top_left.y,
+				it->clip_rect.bottom_right.x, it->clip_rect.bottom_right.y,
+				(it->vertex_end - it->vertex_start) / VERTEX_SIZE_FLOATS, it->index_end - it->index_start, it->index_start);
+			if (it == painter.last_command)
+			{
+				break;
+			}
+		}
+	}
+
+	fprintf(file, "\n[profiler zones]\n");
+#ifdef LGUI_PROFILER
+	if (context->profiler.prev_markers)
+	{
+		_profiler_write_prev_zones(file);
+	}
+	else
+	{
+		fprintf(file, "profiler disabled\n");
+	}
+#else
+	fprintf(file, "not compiled in (LGUI_PROFILER)\n");
+#endif
+
+	fclose(file);
+	++watchdog.capture_count;
+}
+
+void frame_watchdog_end()
+{
+	FrameWatchdog& watchdog = get_context()->frame_watchdog;
+	if (watchdog.pending_frame)
+	{
+		_write_capture();
+	}
+	watchdog = {};
+}
+
+void _frame_watchdog_begin_frame()
+{
+	FrameWatchdog& watchdog = get_context()->frame_watchdog;
+	if (!watchdog.budget_ns)
+	{
+		return;
+	}
+
+	if (watchdog.pending_frame)
+	{
+		_write_capture();
+		watchdog.pending_frame = 0;
+	}
+
+	// After writing the capture, so it doesn't make the next frame slow as well
+	watchdog.frame_start_ns = get_time_ns();
+}
+
+void _frame_watchdog_end_frame()
+{
+	Context* context = get_context();
+	FrameWatchdog& watchdog = context->frame_watchdog;
+	if (!watchdog.budget_ns)
+	{
+		return;
+	}
+
+	watchdog.last_frame_ns = get_time_ns() - watchdog.frame_start_ns;
+	if (watchdog.last_frame_ns > watchdog.budget_ns &&
+		(!watchdog.max_captures || watchdog.capture_count < watchdog.max_captures))
+	{
+		watchdog.pending_frame = context->current_frame;
+		watchdog.pending_frame_ns = watchdog.last_frame_ns;
+	}
+}
+
+}
@@ -0,0 +1,131 @@
+// Hash policies for the IDs, chosen at build time (premake --hash=table|sse42|fast)
+#include "lag_gui.hpp"
+#include "basic.hpp"
+#include "crc32.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define LGUI_HAS_SSE42 1
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define LGUI_TARGET_SSE42
+#else
+#define LGUI_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#else
+#define LGUI_HAS_SSE42 0
+#endif
+
+namespace lgui {
+
+u32 hash_crc32_table(const byte* data, usize length, u32 seed)
+{
+	return xcrc32(data, (int)length, seed);
+}
+
+#if LGUI_HAS_SSE42
+// CRC32C (not the same polynomial as the table), 8 bytes per instruction
+LGUI_TARGET_SSE42 u32 hash_crc32_sse42(const byte* data, usize length, u32 seed)
+{
+	u64 crc = ~seed;
+	while (length >= 8)
+	{
+		u64 word;
+		memcpy(&word, data, sizeof(word));
+		crc = _mm_crc32_u64(crc, word);
+		data += 8;
+		length -= 8;
+	}
+
+	u32 crc32 = (u32)crc;
+	if (length >= 4)
+	{
+		u32 word;
+		memcpy(&word, data, sizeof(word));
+		crc32 = _mm_crc32_u32(crc32, word);
+		data += 4;
+		length -= 4;
+	}
+	for (usize i = 0; i < length; ++i)
+	{
+		crc32 = _mm_crc32_u8(crc32, data[i]);
+	}
+	return ~crc32;
+}
+
+bool hash_sse42_supported()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] >> 20) & 1;
+#else
+	return __builtin_cpu_supports("sse4.2");
+#endif
+}
+#else
+u32 hash_crc32_sse42(const byte* data, usize length, u32 seed)
+{
+	LGUI_TRAP("SSE4.2 is only available on x64");
+}
+
+bool hash_sse42_supported()
+{
+	return false;
+}
+#endif
+
+// Multiply and xorshift over 8 byte words, finished with the MurmurHash3 finalizer
+u32 hash_fast64(const byte* data, usize length, u32 seed)
+{
+	const u64 multiplier = 0x9E3779B97F4A7C15ull;
+	u64 hash = ((u64)seed << 32 | length) * multiplier;
+	while (length >= 8)
+	{
+		u64 word;
+		memcpy(&word, data, sizeof(word));
+		hash = (hash ^ word) * multiplier;
+		hash ^= hash >> 29;
+		data += 8;
+		length -= 8;
+	}
+	if (length)
+	{
+		// Overlapping loads instead of a variable length copy
+		u64 word;
+		if (length >= 4)
+		{
+			u32 low;
+			u32 high;
+			memcpy(&low, data, sizeof(low));
+			memcpy(&high, data + length - 4, sizeof(high));
+			word = (u64)high << 32 | low;
+		}
+		else
+		{
+			word = (u64)data[0] | (u64)data[length / 2] << 8 | (u64)data[length - 1] << 16;
+		}
+		hash = (hash ^ word) * multiplier;
+		hash ^= hash >> 29;
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ull;
+	hash ^= hash >> 33;
+	return (u32)hash;
+}
+
+u32 hash_bytes(const byte* data, usize length, u32 seed)
+{
+#if defined(LGUI_HASH_SSE42)
+	return hash_crc32_sse42(data, length, seed);
+#elif defined(LGUI_HASH_FAST)
+	return hash_fast64(data, length, seed);
+#else
+	return hash_crc32_table(data, length, seed);
+#endif
+}
+
+}
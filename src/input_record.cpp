@@ -0,0 +1,229 @@
+#include "lag_gui.hpp"
+#include "basic.hpp"
+#include "crc32.hpp"
+#include <stdio.h>
+
+namespace lgui {
+
+// File layout (native endianness):
+//   header: magic "LGIR", u32 version
+//   frame:  f32 delta_time, f32 window_size[2], f32 mouse_pos[2], f32 scroll_wheel[2], u8 mouse_buttons,
+//           u16 key_change_count, {u16 key, u8 down}[key_change_count],
+//           u8 codepoint_count, i32 codepoints[codepoint_count]
+const char INPUT_RECORD_MAGIC[4] = {'L', 'G', 'I', 'R'};
+const u32 INPUT_RECORD_VERSION = 1;
+
+template<typename T>
+static void _write(FILE* file, const T& value)
+{
+	fwrite(&value, sizeof(T), 1, file);
+}
+
+template<typename T>
+static bool _read(FILE* file, T* value)
+{
+	return fread(value, sizeof(T), 1, file) == 1;
+}
+
+bool input_record_begin(const char* filename)
+{
+	Context* context = get_context();
+	InputRecorder& recorder = context->input_recorder;
+	LGUI_ASSERT(recorder.mode == InputRecordMode_None, "Already recording or replaying");
+
+	FILE* file;
+	if (fopen_s(&file, filename, "wb"))
+	{
+		return false;
+	}
+
+	fwrite(INPUT_RECORD_MAGIC, 1, sizeof(INPUT_RECORD_MAGIC), file);
+	_write(file, INPUT_RECORD_VERSION);
+
+	recorder = {};
+	recorder.mode = InputRecordMode_Record;
+	recorder.file = file;
+	return true;
+}
+
+void input_record_end()
+{
+	InputRecorder& recorder = get_context()->input_recorder;
+	if (recorder.mode != InputRecordMode_Record)
+	{
+		return;
+	}
+
+	fclose((FILE*)recorder.file);
+	recorder = {};
+}
+
+void _input_record_frame(f32 delta_time, const MouseState& mouse_state)
+{
+	Context* context = get_context();
+	InputRecorder& recorder = context->input_recorder;
+	FILE* file = (FILE*)recorder.file;
+
+	_write(file, delta_time);
+	_write(file, context->app_window_size.x);
+	_write(file, context->app_window_size.y);
+	_write(file, mouse_state.pos.x);
+	_write(file, mouse_state.pos.y);
+	_write(file, mouse_state.scroll_wheel.x);
+	_write(file, mouse_state.scroll_wheel.y);
+	u8 buttons = 0;
+	for (u8 i = 0; i < 3; ++i)
+	{
+		buttons |= mouse_state.buttons[i] ? (u8)(1 << i) : 0;
+	}
+	_write(file, buttons);
+
+	// Keys that changed since the last recorded frame
+	u16 key_change_count = 0;
+	for (u16 i = 0; i < Key::MAX; ++i)
+	{
+		bool down = context->keys[i] & Key::CURRENT_FRAME_MASK;
+		key_change_count += down != recorder.keys_down[i];
+	}
+	_write(file, key_change_count);
+	for (u16 i = 0; i < Key::MAX; ++i)
+	{
+		bool down = context->keys[i] & Key::CURRENT_FRAME_MASK;
+		if (down != recorder.keys_down[i])
+		{
+			recorder.keys_down[i] = down;
+			_write(file, i);
+			_write(file, (u8)down);
+		}
+	}
+
+	u8 codepoint_count = (u8)context->codepoints_pressed_length;
+	_write(file, codepoint_count);
+	fwrite(context->codepoints_pressed, sizeof(Codepoint), codepoint_count, file);
+
+	++recorder.frame_count;
+}
+
+bool input_replay_begin(const char* filename)
+{
+	Context* context = get_context();
+	InputRecorder& recorder = context->input_recorder;
+	LGUI_ASSERT(recorder.mode == InputRecordMode_None, "Already recording or replaying");
+
+	FILE* file;
+	if (fopen_s(&file, filename, "rb"))
+	{
+		return false;
+	}
+
+	char magic[4];
+	u32 version;
+	if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+		memcmp(magic, INPUT_RECORD_MAGIC, sizeof(magic)) != 0 ||
+		!_read(file, &version) || version != INPUT_RECORD_VERSION)
+	{
+		fclose(file);
+		return false;
+	}
+
+	recorder = {};
+	recorder.mode = InputRecordMode_Replay;
+	recorder.file = file;
+	return true;
+}
+
+void input_replay_end()
+{
+	InputRecorder& recorder = get_context()->input_recorder;
+	if (recorder.mode != InputRecordMode_Replay)
+	{
+		return;
+	}
+
+	fclose((FILE*)recorder.file);
+	recorder = {};
+}
+
+bool input_replay_frame()
+{
+	Context* context = get_context();
+	InputRecorder& recorder = context->input_recorder;
+	LGUI_ASSERT(recorder.mode == InputRecordMode_Replay, "No replay started");
+	FILE* file = (FILE*)recorder.file;
+
+	f32 delta_time;
+	v2 window_size;
+	MouseState mouse_state{};
+	u8 buttons;
+	u16 key_change_count;
+	if (!_read(file, &delta_time) ||
+		!_read(file, &window_size.x) || !_read(file, &window_size.y) ||
+		!_read(file, &mouse_state.pos.x) || !_read(file, &mouse_state.pos.y) ||
+		!_read(file, &mouse_state.scroll_wheel.x) || !_read(file, &mouse_state.scroll_wheel.y) ||
+		!_read(file, &buttons) || !_read(file, &key_change_count))
+	{
+		return false;
+	}
+	for (u8 i = 0; i < 3; ++i)
+	{
+		mouse_state.buttons[i] = buttons & (1 << i);
+	}
+
+	for (u16 i = 0; i < key_change_count; ++i)
+	{
+		u16 key;
+		u8 down;
+		if (!_read(file, &key) || !_read(file, &down) || key >= Key::MAX)
+		{
+			return false;
+		}
+		recorder.keys_down[key] = down;
+	}
+	for (u16 i = 0; i < Key::MAX; ++i)
+	{
+		input_register_key_down(i, recorder.keys_down[i]);
+	}
+
+	u8 codepoint_count;
+	if (!_read(file, &codepoint_count))
+	{
+		return false;
+	}
+	for (u8 i = 0; i < codepoint_count; ++i)
+	{
+		Codepoint codepoint;
+		if (!_read(file, &codepoint))
+		{
+			return false;
+		}
+		input_register_char_press(codepoint);
+	}
+
+	++recorder.frame_count;
+	context->app_window_size = window_size;
+	begin_frame(delta_time, mouse_state);
+	return true;
+}
+
+u32 get_draw_buffer_hash()
+{
+	Context* context = get_context();
+	DrawBuffer& draw_buffer = context->draw_buffer;
+
+	u32 hash = xcrc32((const byte*)draw_buffer.vertex_buffer, (int)(draw_buffer.vertex_buffer_top * sizeof(f32)), 0);
+	hash = xcrc32((const byte*)draw_buffer.index_buffer, (int)(draw_buffer.index_buffer_top * sizeof(DrawIndex)), hash);
+
+	// Commands in render order
+	for (Panel* panel = context->first_depth_panel; panel; panel = panel->order_next)
+	{
+		for (DrawCommand* command = panel->painter.first_command; command; command = command->next)
+		{
+			hash = xcrc32((const byte*)&command->clip_rect, (int)sizeof(command->clip_rect), hash);
+			hash = xcrc32((const byte*)&command->index_start, (int)sizeof(command->index_start), hash);
+			hash = xcrc32((const byte*)&command->index_end, (int)sizeof(command->index_end), hash);
+		}
+	}
+	return hash;
+}
+
+}
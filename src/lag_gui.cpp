@@ -1,12 +1,12 @@
 #include "lag_gui.hpp"
 #include "basic.hpp"
-#include "crc32.hpp"
 #include <string.h>
 
 #include "raylib.h"
 #include "rlgl.h"
 #include "stb_truetype.h"
 #include <stdio.h>
+#include <chrono>
 
 namespace lgui {
 
@@ -32,7 +32,9 @@ static void dock_into(Panel* from, Panel* into, DockEntry entry);
 static void push_panel(Panel* panel);
 static void pop_panel();
 static void _delete_old_panels();
+static void _evict_interned_strings(Context* context);
 static void _draw_boxes(Painter& painter, Box* root, v2 start_pos);
+static void _draw_layout_heat_map(Painter& painter, Panel* panel);
 
 static f32 lerp(f32 v1, f32 v2, f32 t)
 {
@@ -40,19 +42,82 @@ static f32 lerp(f32 v1, f32 v2, f32 t)
 }
 
 Context* init(usize arena_size_mb)
+{
+	InitOptions options{};
+	options.arena_size_mb = arena_size_mb;
+	return init(options);
+}
+
+static Arena _create_arena(const InitOptions& options)
+{
+	usize size = LGUI_MB(options.arena_size_mb);
+	if (options.arena_reserve_mb)
+	{
+		return Arena::reserve(LGUI_MB(options.arena_reserve_mb), size, options.huge_pages);
+	}
+	if (options.huge_pages)
+	{
+		// Reserving only the fixed size keeps the arena from growing
+		return Arena::reserve(size, size, true);
+	}
+	return Arena::from_memory(malloc(size), size);
+}
+
+static Arena _create_scratch_arena(const InitOptions& options)
+{
+	if (!options.scratch_arena_size_mb)
+	{
+		return _create_arena(options);
+	}
+
+	InitOptions scratch_options = options;
+	if (options.arena_reserve_mb)
+	{
+		scratch_options.arena_size_mb = LGUI_MIN(options.arena_size_mb, options.scratch_arena_size_mb);
+		scratch_options.arena_reserve_mb = options.scratch_arena_size_mb;
+	}
+	else
+	{
+		scratch_options.arena_size_mb = options.scratch_arena_size_mb;
+	}
+	return _create_arena(scratch_options);
+}
+
+static void _destroy_arena(Arena arena)
+{
+	if (arena.reserved)
+	{
+		arena.release();
+	}
+	else
+	{
+		free(arena.ptr);
+	}
+}
+
+Context* init(const InitOptions& options)
 {
 	LGUI_ASSERT(g_context == nullptr, "The library has already been initialized");
 
-	usize mem_size = LGUI_MB(arena_size_mb);
-	Arena arena = Arena::from_memory(malloc(mem_size), mem_size);
+	Arena arena = _create_arena(options);
 
 	Context* ret = arena.allocate_one<Context>();
 	g_context = ret;
 
 	ret->arena = arena;
-	ret->temp_arena_arr[0] = Arena::from_memory(malloc(mem_size), mem_size);
-	ret->temp_arena_arr[1] = Arena::from_memory(malloc(mem_size), mem_size);
+	ret->temp_arena_arr[0] = _create_arena(options);
+	ret->temp_arena_arr[1] = _create_arena(options);
 	ret->temp_arena = &ret->temp_arena_arr[0];
+	for (usize i = 0; i < SCRATCH_ARENA_COUNT; ++i)
+	{
+		ret->scratch_arenas[i] = _create_scratch_arena(options);
+	}
+	ret->temp_arena_trim_interval = options.temp_arena_trim_interval;
+	ret->retained_data_max_age = options.retained_data_max_age;
+	ret->retained_data_store.init(options.retained_data_max ? options.retained_data_max : RETAINED_DATA_MAX);
+	ret->hash_map_blocks.arena = &ret->arena;
+	ret->panel_map.allocator = &ret->hash_map_blocks;
+	ret->interned_strings.allocator = &ret->hash_map_blocks;
 
 	ret->draw_buffer.allocate();
 	ret->current_frame = 1;
@@ -62,27 +127,97 @@ Context* init(usize arena_size_mb)
 
 void deinit()
 {
-	free(g_context->temp_arena_arr[0].ptr);
-	free(g_context->temp_arena_arr[1].ptr);
-	free(g_context->arena.ptr);
+	input_record_end();
+	input_replay_end();
+	frame_watchdog_end();
+
+	// The context itself lives in the persistent arena
+	g_context->retained_data_store.release();
+	_destroy_arena(g_context->temp_arena_arr[0]);
+	_destroy_arena(g_context->temp_arena_arr[1]);
+	for (usize i = 0; i < SCRATCH_ARENA_COUNT; ++i)
+	{
+		_destroy_arena(g_context->scratch_arenas[i]);
+	}
+	_destroy_arena(g_context->arena);
 
 	g_context = nullptr;
 }
 
 void begin_frame(f32 delta_time)
+{
+	MouseState state{};
+	state.buttons[0] = IsMouseButtonDown(0);
+	state.buttons[1] = IsMouseButtonDown(1);
+	state.buttons[2] = IsMouseButtonDown(2);
+	state.pos = v2::from(GetMousePosition());
+	state.scroll_wheel = v2::from(GetMouseWheelMoveV());
+
+	begin_frame(delta_time, state);
+}
+
+void begin_frame(f32 delta_time, const MouseState& mouse_state)
 {
 	Context* context = get_context();
 
+	// Swap temorary arenas
+	context->temp_arena = &context->temp_arena_arr[context->current_frame % 2];
+	context->memory_stats.temp_arena_frame_used[context->current_frame % 2] = context->temp_arena->used;
+	context->temp_arena->reset();
+	// Both temporary arenas are trimmed, one in each of two consecutive frames
+	if (context->temp_arena_trim_interval && context->current_frame % context->temp_arena_trim_interval < 2)
+	{
+		context->temp_arena->trim();
+	}
+	if (context->temp_arena_trim_interval && context->current_frame % context->temp_arena_trim_interval == 0)
+	{
+		for (usize i = 0; i < SCRATCH_ARENA_COUNT; ++i)
+		{
+			LGUI_ASSERT(context->scratch_arenas[i].used == 0, "Scratch arena still in use at the start of the frame");
+			context->scratch_arenas[i].trim();
+		}
+	}
+
+	// Start new allocation counters
+	memcpy(context->memory_stats.prev_frame, context->memory_stats.frame, sizeof(context->memory_stats.frame));
+	memset(context->memory_stats.frame, 0, sizeof(context->memory_stats.frame));
+
+#ifdef LGUI_PROFILER
+	_profiler_begin_frame();
+#endif
+	// Before anything of the previous frame is deleted
+	_frame_watchdog_begin_frame();
+	LGUI_PROFILE_ZONE("begin_frame");
+
+	if (context->input_recorder.mode == InputRecordMode_Record)
+	{
+		_input_record_frame(delta_time, mouse_state);
+	}
+
 	context->draw_buffer.vertex_buffer_top = 0;
 	context->draw_buffer.index_buffer_top = 0;
+	context->draw_buffer.prev_stats = context->draw_buffer.stats;
+	context->draw_buffer.stats = {};
+
+	context->layout_heat_map_active = context->layout_heat_map_enabled;
 
 	_delete_old_panels();
+	_evict_interned_strings(context);
 
-	context->delta_time = delta_time;
+	// Moves the retained data of the deleted panels and of the evicted entries out of the way
+	// Done when a quarter of the store is holes, and before every trim so the trim can give that memory back
+	HandleStore<RetainedData>& retained_store = context->retained_data_store;
+	bool trim_retained_data = context->temp_arena_trim_interval && context->current_frame % context->temp_arena_trim_interval == 0;
+	if (retained_store.hole_count && (retained_store.hole_count * 4 >= retained_store.object_count || trim_retained_data))
+	{
+		retained_store.compact();
+	}
+	if (trim_retained_data)
+	{
+		retained_store.trim();
+	}
 
-	// Swap temorary arenas
-	context->temp_arena = &context->temp_arena_arr[context->current_frame % 2];
-	context->temp_arena->reset();
+	context->delta_time = delta_time;
 
 	// Input
 	{
@@ -95,21 +230,14 @@ void begin_frame(f32 delta_time)
 
 		// Insert new mouse input
 		{
-			MouseState state{};
-			state.buttons[0] = IsMouseButtonDown(0);
-			state.buttons[1] = IsMouseButtonDown(1);
-			state.buttons[2] = IsMouseButtonDown(2);
-			state.pos = v2::from(GetMousePosition());
-			state.scroll_wheel = v2::from(GetMouseWheelMoveV());
-
 			context->mouse_states[1] = context->mouse_states[0];
-			context->mouse_states[0] = state;
+			context->mouse_states[0] = mouse_state;
 
 			for (int i = 0; i < 3; ++i)
 			{
 				if (mouse_pressed(i))
 				{
-					context->mouse_pressed_pos[i] = state.pos;
+					context->mouse_pressed_pos[i] = mouse_state.pos;
 				}
 			}
 		}
@@ -125,7 +253,7 @@ void begin_frame(f32 delta_time)
 
 	// Find overlap panel
 	{
-		v2 mouse = v2::from(GetMousePosition());
+		v2 mouse = mouse_state.pos;
 
 		context->overlap_panel = nullptr;
 		for (Panel* panel = context->first_depth_panel; panel; panel = panel->order_next)
@@ -149,6 +277,7 @@ void begin_frame(f32 delta_time)
 void end_frame()
 {
 	Context* context = get_context();
+	LGUI_PROFILE_ZONE("end_frame");
 
 	// Run dock commands
 	for (DockCommand* command = context->first_dock_command; command; command = command->next)
@@ -199,6 +328,8 @@ void end_frame()
 		// Reset codepoints
 		context->codepoints_pressed_length = 0;
 	}
+
+	_frame_watchdog_end_frame();
 }
 
 void draw_frame()
@@ -213,17 +344,50 @@ bool is_anything_hovered()
 	return context->hover_id != 0;
 }
 
+const MemoryStats& get_memory_stats()
+{
+	return get_context()->memory_stats;
+}
+
+const PanelMemoryStats* get_panel_memory_stats(const char* name)
+{
+	Panel* panel = get_panel(get_id(name));
+	return panel ? &panel->memory_stats : nullptr;
+}
+
+u64 get_time_ns()
+{
+	using namespace std::chrono;
+	return (u64)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+ArenaMarker get_scratch(Arena* conflict)
+{
+	Context* context = get_context();
+	Arena* arena = &context->scratch_arenas[0] == conflict ? &context->scratch_arenas[1] : &context->scratch_arenas[0];
+	return arena->make_marker();
+}
+
 ID calc_id(const byte* data, usize length)
 {
 	Context* context = get_context();
 
 	ID top = context->id_stack_top > 0 ? context->id_top : 123456;
-	return xcrc32(data, (int)length, top);
+	return hash_bytes(data, length, top);
 }
 
+// Same ID as the Label of the string, so string and literal labels can be mixed
 ID get_id(const char* string)
 {
-	return calc_id((const byte*)string, strlen(string));
+	return get_id(Label(string));
+}
+
+ID get_id(const Label& label)
+{
+	Context* context = get_context();
+
+	ID top = context->id_stack_top > 0 ? context->id_top : 123456;
+	return combine_id(label.hash, top);
 }
 
 ID get_id(i32 i)
@@ -266,6 +430,11 @@ void push_id(const char* string)
 	_push_id(get_id(string));
 }
 
+void push_id(const Label& label)
+{
+	_push_id(get_id(label));
+}
+
 void push_id(i32 i)
 {
 	_push_id(get_id(i));
@@ -364,8 +533,7 @@ static Dock* make_dock()
 {
 	Context* context = get_context();
 
-	// TODO: Add free list for docks
-	Dock* ret = context->arena.allocate_one<Dock>();
+	Dock* ret = context->dock_pool.allocate(&context->arena);
 	return ret;
 }
 
@@ -540,6 +708,61 @@ static void dock_into(Panel* from, Panel* into, DockEntry entry)
 	}
 }
 
+// Removes a tab from its dock, an empty leaf is replaced by its sibling
+// Returns the root panel when the whole dock is empty, the caller has to delete it
+static Panel* _dock_remove_tab(Panel* panel)
+{
+	Context* context = get_context();
+
+	Dock* dock = panel->parent_dock;
+	LGUI_ASSERT(dock->is_leaf(), "Tab must be in a leaf dock");
+	LGUI_LL_REMOVE(panel, prev_dock_tab, next_dock_tab, dock->first_tab, dock->last_tab);
+	if (dock->selected_tab == panel)
+	{
+		dock->selected_tab = dock->first_tab;
+	}
+
+	panel->parent_dock = nullptr;
+	panel->next_dock_tab = nullptr;
+	panel->prev_dock_tab = nullptr;
+	panel->root_dock_panel = nullptr;
+
+	if (dock->first_tab)
+	{
+		return nullptr;
+	}
+
+	Panel* root_panel = dock->root_panel;
+	Dock* parent = dock->parent_dock;
+	if (!parent)
+	{
+		// Last tab of the whole dock
+		context->dock_pool.free(dock);
+		return root_panel;
+	}
+
+	// Move the sibling up into the place of the parent
+	Dock* sibling = parent->child_docks[0] == dock ? parent->child_docks[1] : parent->child_docks[0];
+	Dock* grandparent = parent->parent_dock;
+	sibling->parent_dock = grandparent;
+	if (grandparent)
+	{
+		int index = grandparent->child_docks[0] == parent ? 0 : 1;
+		grandparent->child_docks[index] = sibling;
+	}
+	else
+	{
+		root_panel->parent_dock = sibling;
+	}
+
+	// The children and tabs of the sibling are laid out from this rect in root_dock_update
+	sibling->rect = parent->rect;
+
+	context->dock_pool.free(dock);
+	context->dock_pool.free(parent);
+	return nullptr;
+}
+
 const f32 DOCK_TITLE_BAR_HEIGHT = 20.f;
 
 static void dock_calc_panel_and_title_rect(Dock* dock, Rect* title_rect, Rect* panel_rect)
@@ -597,7 +820,7 @@ static void root_dock_update_from_panel(Dock* dock, Panel* panel)
 	{
 		// TODO: Maybe change this to use each sub-window title bar instead, because that way I can select the window as well
 
-		InputResult result = handle_element_input(dock_root->rect, get_id("__panel_drag"), true);
+		InputResult result = handle_element_input(dock_root->rect, get_id(LGUI_ID_LIT("__panel_drag")), true);
 		if (result.dragging)
 		{
 			move_all_child_docks(dock_root, result.drag_delta);
@@ -727,7 +950,7 @@ static void _end_dock_update_input(Dock* dock)
 		resize_rect = rect.cut_top(4);
 	}
 
-	InputResult input = handle_element_input(resize_rect, get_id("__resize_split_bar"), true);
+	InputResult input = handle_element_input(resize_rect, get_id(LGUI_ID_LIT("__resize_split_bar")), true);
 
 	// Debug
 	{
@@ -760,6 +983,8 @@ static void _end_dock_update_input(Dock* dock)
 
 static void root_dock_update(Dock* dock)
 {
+	LGUI_PROFILE_ZONE("root_dock_update");
+
 	push_panel(dock->root_panel);
 	push_id(dock->root_panel->id);
 	Painter& painter = dock->root_panel->get_painter();
@@ -779,10 +1004,10 @@ static void root_dock_update(Dock* dock)
 	{
 		// Panel resizing (the lines in-between panels)
 
-		InputResult top = handle_element_input(panel_top, get_id("__resize_top"), true);
-		InputResult bottom = handle_element_input(panel_bottom, get_id("__resize_bottom"), true);
-		InputResult left = handle_element_input(panel_left, get_id("__resize_left"), true);
-		InputResult right = handle_element_input(panel_right, get_id("__resize_right"), true);
+		InputResult top = handle_element_input(panel_top, get_id(LGUI_ID_LIT("__resize_top")), true);
+		InputResult bottom = handle_element_input(panel_bottom, get_id(LGUI_ID_LIT("__resize_bottom")), true);
+		InputResult left = handle_element_input(panel_left, get_id(LGUI_ID_LIT("__resize_left")), true);
+		InputResult right = handle_element_input(panel_right, get_id(LGUI_ID_LIT("__resize_right")), true);
 
 		if (top.dragging)
 		{
@@ -809,6 +1034,9 @@ static void root_dock_update(Dock* dock)
 
 	}
 
+	// The root panel never goes through begin_panel, keep it alive
+	dock->root_panel->frame_last_updated = get_context()->current_frame;
+
 	// Update all layouts now that size is known
 	dock->root_panel->rect = dock->rect;
 	_end_dock_update_layout(dock);
@@ -827,87 +1055,103 @@ static void check_docking(Panel* panel, InputResult* input_result)
 		Painter& painter = panel->get_painter();
 
 		// Iterate over all existing panels
-		for (usize i = 0; i < PANEL_MAP_SIZE; ++i)
+		for (u32 i = 0; i < context->panel_map.capacity; ++i)
 		{
-			for (Panel* it = context->panel_map[i]; it; it = it->hash_next)
-			{
-				if (it == panel) continue;
+			if (!context->panel_map.entries[i].used) continue;
+			Panel* it = context->panel_map.entries[i].value;
+			if (it == panel) continue;
 
-				Rect rect = it->rect;
-				if (!rect.overlap(panel->rect)) continue;
+			Rect rect = it->rect;
+			if (!rect.overlap(panel->rect)) continue;
 
-				Rect center = rect.center_size(v2{50, 50});
-				Rect left = rect.get_left(50).center_size({50, 50});
-				Rect right = rect.get_right(50).center_size({50, 50});
-				Rect top = rect.get_top(50).center_size({50, 50});
-				Rect bottom = rect.get_bottom(50).center_size({50, 50});
+			Rect center = rect.center_size(v2{50, 50});
+			Rect left = rect.get_left(50).center_size({50, 50});
+			Rect right = rect.get_right(50).center_size({50, 50});
+			Rect top = rect.get_top(50).center_size({50, 50});
+			Rect bottom = rect.get_bottom(50).center_size({50, 50});
 
-				Color c = {0, 0, 1, 1};
-				painter.draw_rectangle(center, c);
-				painter.draw_rectangle(left, c);
-				painter.draw_rectangle(right, c);
-				painter.draw_rectangle(top, c);
-				painter.draw_rectangle(bottom, c);
+			Color c = {0, 0, 1, 1};
+			painter.draw_rectangle(center, c);
+			painter.draw_rectangle(left, c);
+			painter.draw_rectangle(right, c);
+			painter.draw_rectangle(top, c);
+			painter.draw_rectangle(bottom, c);
 
-				if (input_result->released)
+			if (input_result->released)
+			{
+				if (center.overlap(mouse_pos()))
 				{
-					if (center.overlap(mouse_pos()))
-					{
-						//dock_into(context, panel, it, DockEntry_Into);
-						DockCommand command{};
-						command.type = DockCommandType_DockInto;
-						command.panel1 = panel;
-						command.panel2 = it;
-						command.entry = DockEntry_Into;
-						push_dock_command(command);
-						return;
-					}
-					else if (left.overlap(mouse_pos()))
-					{
-						DockCommand command{};
-						command.type = DockCommandType_DockInto;
-						command.panel1 = panel;
-						command.panel2 = it;
-						command.entry = DockEntry_Left;
-						push_dock_command(command);
-						return;
-					}
-					else if (right.overlap(mouse_pos()))
-					{
-						DockCommand command{};
-						command.type = DockCommandType_DockInto;
-						command.panel1 = panel;
-						command.panel2 = it;
-						command.entry = DockEntry_Right;
-						push_dock_command(command);
-						return;
-					}
-					else if (top.overlap(mouse_pos()))
-					{
-						DockCommand command{};
-						command.type = DockCommandType_DockInto;
-						command.panel1 = panel;
-						command.panel2 = it;
-						command.entry = DockEntry_Top;
-						push_dock_command(command);
-						return;
-					}
-					else if (bottom.overlap(mouse_pos()))
-					{
-						DockCommand command{};
-						command.type = DockCommandType_DockInto;
-						command.panel1 = panel;
-						command.panel2 = it;
-						command.entry = DockEntry_Bottom;
-						push_dock_command(command);
-						return;
-					}
+					//dock_into(context, panel, it, DockEntry_Into);
+					DockCommand command{};
+					command.type = DockCommandType_DockInto;
+					command.panel1 = panel;
+					command.panel2 = it;
+					command.entry = DockEntry_Into;
+					push_dock_command(command);
+					return;
+				}
+				else if (left.overlap(mouse_pos()))
+				{
+					DockCommand command{};
+					command.type = DockCommandType_DockInto;
+					command.panel1 = panel;
+					command.panel2 = it;
+					command.entry = DockEntry_Left;
+					push_dock_command(command);
+					return;
+				}
+				else if (right.overlap(mouse_pos()))
+				{
+					DockCommand command{};
+					command.type = DockCommandType_DockInto;
+					command.panel1 = panel;
+					command.panel2 = it;
+					command.entry = DockEntry_Right;
+					push_dock_command(command);
+					return;
+				}
+				else if (top.overlap(mouse_pos()))
+				{
+					DockCommand command{};
+					command.type = DockCommandType_DockInto;
+					command.panel1 = panel;
+					command.panel2 = it;
+					command.entry = DockEntry_Top;
+					push_dock_command(command);
+					return;
+				}
+				else if (bottom.overlap(mouse_pos()))
+				{
+					DockCommand command{};
+					command.type = DockCommandType_DockInto;
+					command.panel1 = panel;
+					command.panel2 = it;
+					command.entry = DockEntry_Bottom;
+					push_dock_command(command);
+					return;
 				}
 			}
 		}
 	}
 }
 
+void dock_panel(const char* name, const char* into_name, DockEntry entry)
+{
+	Panel* panel = get_panel(get_id(name));
+	Panel* into = get_panel(get_id(into_name));
+	if (!panel || !into || panel == into || panel->is_docked())
+	{
+		return;
+	}
+
+	DockCommand command{};
+	command.type = DockCommandType_DockInto;
+	command.panel1 = panel;
+	command.panel2 = into;
+	command.entry = entry;
+	push_dock_command(command);
+}
+
 // Docking
 #pragma endregion
 
@@ -915,11 +1159,8 @@ Panel* get_panel(ID id)
 {
 	Context* context = get_context();
 
-	for (Panel* it = context->panel_map[id % PANEL_MAP_SIZE]; it; it = it->hash_next)
-	{
-		if (it->id == id) return it;
-	}
-	return nullptr;
+	Panel** ret = context->panel_map.find(id);
+	return ret ? *ret : nullptr;
 }
 
 static Panel* try_get_prev_top_panel()
@@ -950,35 +1191,15 @@ static Panel* _get_or_create_panel(ID id)
 	Context* context = get_context();
 
 	// Try to find panel
-	for (Panel* it = context->panel_map[id % PANEL_MAP_SIZE]; it; it = it->hash_next)
-	{
-		if (it->id == id) return it;
-	}
+	Panel** slot = context->panel_map.insert(id);
+	if (*slot) return *slot;
 
-	// Create new panel object
-	Panel* ret{};
-	if (context->first_free_panel)
-	{
-		ret = context->first_free_panel;
-		context->first_free_panel = context->first_free_panel->order_next;
-		memset(ret, 0, sizeof(Panel));
-	}
-	else
-	{
-		ret = context->arena.allocate_one<Panel>();
-	}
+	// Create new panel object and add it to the panel hash map
+	Panel* ret = context->panel_pool.allocate(&context->arena);
+	_track_allocation(context, AllocationType_Panel, sizeof(Panel));
 	ret->id = id;
-
-	// Add new panel to panel hash map
-	{
-		Panel*& first = context->panel_map[id % PANEL_MAP_SIZE];
-		if (first)
-		{
-			first->hash_prev = ret;
-		}
-		ret->hash_next = first;
-		first = ret;
-	}
+	ret->retained_data_lookup.allocator = &context->hash_map_blocks;
+	*slot = ret;
 
 	// Add panel on top of the depth panel list
 	LGUI_LL_APPEND_END(ret, order_prev, order_next, context->first_depth_panel, context->last_depth_panel);
@@ -990,56 +1211,48 @@ static void _delete_panel(Panel* panel)
 {
 	Context* context = get_context();
 
-	// Remove docking
-	if (panel->is_docked())
+	// Docked tabs are not in the depth list, only their root panel is
+	bool in_depth_list = !panel->is_docked() || panel->is_dock_root;
+
+	// Remove docking, the root panel is deleted with the last tab of its dock
+	Panel* empty_dock_root = nullptr;
+	if (panel->is_docked() && !panel->is_dock_root)
 	{
-		// TODO: Add docking deletion code here
+		empty_dock_root = _dock_remove_tab(panel);
 	}
 
 	// Remove retained data
 	{
-		for (usize i = 0; i < RETAINED_TABLE_SIZE; ++i)
+		HandleStore<RetainedData>& store = context->retained_data_store;
+		HashMap<Handle>& lookup = panel->retained_data_lookup;
+		for (u32 i = 0; i < lookup.capacity; ++i)
 		{
-			// Keep the already existing list structure when inserting them into the free list
-			RetainedData* bucket = panel->retained_data_lookup[i];
-			if (context->first_free_retained_data)
+			if (lookup.entries[i].used)
 			{
-				// Find last element in bucket, then append the current free list
-				// TODO: It would be nice if I didn't have to find the end pointer here, could be an optimization if needed
-				RetainedData* it = bucket;
-				while (it->next) { it = it->next; }
-				it->next = context->first_free_retained_data;
+				store.destroy(lookup.entries[i].value);
 			}
-			context->first_free_retained_data = bucket;
 		}
+		lookup.release();
 	}
 
+	// Remove draw commands
+	panel->painter._free_commands();
+
 	// Remove from panel hash map
+	context->panel_map.erase(panel->id);
+
+	// Remove panel from depth list
+	if (in_depth_list)
 	{
-		Panel*& first = context->panel_map[panel->id % PANEL_MAP_SIZE];
-		if (panel->hash_prev)
-		{
-			panel->hash_prev->hash_next = panel->hash_next;
-		}
-		if (panel->hash_next)
-		{
-			panel->hash_next->hash_prev = panel->hash_prev;
-		}
-		if (first == panel)
-		{
-			first = panel->hash_next;
-		}
+		LGUI_LL_REMOVE(panel, order_prev, order_next, context->first_depth_panel, context->last_depth_panel);
 	}
 
-	// Remove panel from depth list
-	LGUI_LL_REMOVE(panel, order_prev, order_next, context->first_depth_panel, context->last_depth_panel);
+	// Add to free list, uses the order pointer
+	context->panel_pool.free(panel);
 
-	// Add to free list
-	if (context->first_free_panel)
+	if (empty_dock_root)
 	{
-		// Use order pointer as free list pointer
-		panel->order_next = context->first_free_panel;
-		context->first_free_panel = panel;
+		_delete_panel(empty_dock_root);
 	}
 }
 
@@ -1051,31 +1264,32 @@ struct ToDeletePanel {
 static void _delete_old_panels()
 {
 	Context* context = get_context();
+	LGUI_PROFILE_ZONE("_delete_old_panels");
 
 	ToDeletePanel* to_delete = nullptr;
 
 	auto current_frame = context->current_frame;
-	for (usize i = 0; i < PANEL_MAP_SIZE; ++i)
+	for (u32 i = 0; i < context->panel_map.capacity; ++i)
 	{
-		for (Panel* it = context->panel_map[i]; it; it = it->hash_next)
+		if (!context->panel_map.entries[i].used) continue;
+		Panel* it = context->panel_map.entries[i].value;
+		// Dock root panels are deleted together with the last tab of their dock
+		if (it->frame_last_updated != current_frame && !it->is_dock_root)
 		{
-			if (it->frame_last_updated != current_frame)
-			{
-				// Schedule panel to be deleted
-				ToDeletePanel* delete_node = context->temp_arena->allocate_one<ToDeletePanel>();
-				delete_node->panel = it;
-				delete_node->next = to_delete;
-				to_delete = delete_node;
-			}
+			// Schedule panel to be deleted
+			ToDeletePanel* delete_node = context->temp_arena->allocate_one<ToDeletePanel>();
+			delete_node->panel = it;
+			delete_node->next = to_delete;
+			to_delete = delete_node;
 		}
 	}
 
 	// Perform scheduled deletion
 	for (ToDeletePanel* it = to_delete; it; it = it->next)
 	{
-		// TODO: Temporarily disabled because it causes docking windows to be deleted
 		_delete_panel(it->panel);
 	}
+	context->panel_map.shrink();
 }
 
 // Interpolation that can be called every frame without a T:
@@ -1139,9 +1353,152 @@ static bool is_painter_updated(Painter& painter)
 	return painter.frame_last_updated == context->current_frame;
 }
 
+// Frees the unused retained data of a few entries, every entry is checked once every RETAINED_SWEEP_FRAMES frames
+static void _evict_retained_data(Context* context, Panel* panel)
+{
+	HandleStore<RetainedData>& store = context->retained_data_store;
+	HashMap<Handle>& lookup = panel->retained_data_lookup;
+	u32 sweep_count = (lookup.capacity + RETAINED_SWEEP_FRAMES - 1) / RETAINED_SWEEP_FRAMES;
+	for (u32 i = 0; i < sweep_count; ++i)
+	{
+		u32 index = panel->retained_sweep_index % lookup.capacity;
+		HashMap<Handle>::Entry& entry = lookup.entries[index];
+		if (entry.used && context->current_frame - store.get(entry.value)->frame_last_used > context->retained_data_max_age)
+		{
+			// The next entry can move into this slot, so the index stays
+			store.destroy(entry.value);
+			lookup.erase_at(index);
+			panel->memory_stats.retained_data_count -= 1;
+			panel->memory_stats.retained_data_evicted += 1;
+		}
+		else
+		{
+			panel->retained_sweep_index = index + 1;
+		}
+	}
+	lookup.shrink();
+}
+
+// Frees the strings of a few entries that have not been used for INTERNED_STRING_MAX_AGE frames
+// Every entry is checked once every INTERNED_STRING_SWEEP_FRAMES frames
+static void _evict_interned_strings(Context* context)
+{
+	HashMap<InternedString*>& strings = context->interned_strings;
+	u32 sweep_count = (strings.capacity + INTERNED_STRING_SWEEP_FRAMES - 1) / INTERNED_STRING_SWEEP_FRAMES;
+	for (u32 i = 0; i < sweep_count; ++i)
+	{
+		u32 index = context->interned_sweep_index % strings.capacity;
+		HashMap<InternedString*>::Entry& entry = strings.entries[index];
+		if (!entry.used)
+		{
+			context->interned_sweep_index = index + 1;
+			continue;
+		}
+
+		InternedString** it = &entry.value;
+		while (*it)
+		{
+			InternedString* string = *it;
+			if (context->current_frame - string->frame_last_used > INTERNED_STRING_MAX_AGE)
+			{
+				*it = string->next;
+				context->interned_string_pool.free(string);
+				--context->interned_string_count;
+			}
+			else
+			{
+				it = &string->next;
+			}
+		}
+
+		if (entry.value)
+		{
+			context->interned_sweep_index = index + 1;
+		}
+		else
+		{
+			// The next entry can move into this slot, so the index stays
+			strings.erase_at(index);
+		}
+	}
+	strings.shrink();
+}
+
+// Fibonacci hashing, IDs made from small integers would otherwise cluster
+static u32 _box_lookup_index(const BoxLookup& lookup, ID id)
+{
+	return (id * 2654435769u) >> lookup.shift;
+}
+
+// Filled at most half, newest boxes first so the last box with a duplicate ID wins like it did with the chained table
+static void _build_box_lookup(Context* context, BoxLookup* lookup)
+{
+	LGUI_PROFILE_ZONE("_build_box_lookup");
+	u32 capacity = BOX_LOOKUP_MIN_CAPACITY;
+	while (capacity < lookup->box_count * 2)
+	{
+		capacity *= 2;
+	}
+	u32 shift = 32;
+	for (u32 it = capacity; it > 1; it >>= 1)
+	{
+		--shift;
+	}
+
+	_track_allocation(context, AllocationType_BoxLookup, sizeof(BoxLookupSlot) * capacity);
+	// Unlike the boxes this needs the zeroing, empty slots are null
+	lookup->slots = context->temp_arena->allocate_array<BoxLookupSlot>(capacity, CACHE_LINE_SIZE).ptr;
+	lookup->capacity = capacity;
+	lookup->shift = shift;
+
+	u32 mask = capacity - 1;
+	for (Box* box = lookup->last_allocated; box; box = box->prev_allocated)
+	{
+		u32 i = _box_lookup_index(*lookup, box->id);
+		while (lookup->slots[i].box && lookup->slots[i].id != box->id)
+		{
+			i = (i + 1) & mask;
+		}
+
+		BoxLookupSlot& slot = lookup->slots[i];
+		if (!slot.box)
+		{
+			slot.box = box;
+			slot.id = box->id;
+		}
+	}
+}
+
+static Box* _find_box(Context* context, BoxLookup* lookup, ID id)
+{
+	if (!lookup->slots)
+	{
+		if (!lookup->box_count)
+		{
+			return nullptr;
+		}
+		_build_box_lookup(context, lookup);
+	}
+
+	u32 mask = lookup->capacity - 1;
+	for (u32 i = _box_lookup_index(*lookup, id);; i = (i + 1) & mask)
+	{
+		const BoxLookupSlot& slot = lookup->slots[i];
+		if (!slot.box)
+		{
+			return nullptr;
+		}
+		if (slot.id == id)
+		{
+			return slot.box;
+		}
+	}
+}
+
 bool begin_panel(const char* name, Rect rect, PanelFlag flags)
 {
 	Context* context = get_context();
+	LGUI_PROFILE_ZONE("begin_panel");
 	static Box null_box{};
 	context->box_next_expected = &null_box;
 
@@ -1150,6 +1507,19 @@ bool begin_panel(const char* name, Rect rect, PanelFlag flags)
 	push_panel(panel);
 	Panel* prev_top_panel = try_get_prev_top_panel();
 
+	// Start the memory statistics of this frame, the panel is on top of the stack from here on
+	if (panel->frame_last_updated != context->current_frame)
+	{
+		PanelMemoryStats& stats = panel->memory_stats;
+		memcpy(stats.prev_frame, stats.frame, sizeof(stats.frame));
+		memset(stats.frame, 0, sizeof(stats.frame));
+
+		if (context->retained_data_max_age)
+		{
+			_evict_retained_data(context, panel);
+		}
+	}
+
 	copy_string_to_buffer(panel->name, PANEL_NAME_SIZE, name);
 
 	// End painter of parent panel if it exists
@@ -1204,19 +1574,19 @@ bool begin_panel(const char* name, Rect rect, PanelFlag flags)
 		if (!(flags & PanelFlag_BeginClosed)) panel->open = true;
 
 		// Reset box lookup
-		panel->box_lookup[0] = context->temp_arena->allocate_array<Box*>(BOX_TABLE_SIZE).ptr;
-		panel->box_lookup[1] = context->temp_arena->allocate_array<Box*>(BOX_TABLE_SIZE).ptr;
+		panel->box_lookup[0] = {};
+		panel->box_lookup[1] = {};
 	}
 	else if (panel->frame_last_updated + 1 < context->current_frame)
 	{
 		// Reset box lookup
-		panel->box_lookup[0] = context->temp_arena->allocate_array<Box*>(BOX_TABLE_SIZE).ptr;
-		panel->box_lookup[1] = context->temp_arena->allocate_array<Box*>(BOX_TABLE_SIZE).ptr;
+		panel->box_lookup[0] = {};
+		panel->box_lookup[1] = {};
 	}
 	else
 	{
 		// Normal new frame
-		panel->box_lookup[context->current_frame % 2] = context->temp_arena->allocate_array<Box*>(BOX_TABLE_SIZE).ptr;
+		panel->box_lookup[context->current_frame % 2] = {};
 	}
 	panel->frame_last_updated = context->current_frame;
 
@@ -1234,7 +1604,7 @@ bool begin_panel(const char* name, Rect rect, PanelFlag flags)
 		{
 			// TODO: Change this into a dock command?
 			// Currently this causes flicker when switching back the first panel (but not the other way around?)
-			InputResult input = handle_element_input(panel->dock_tab_rect, get_id("__tab"), true, true);
+			InputResult input = handle_element_input(panel->dock_tab_rect, get_id(LGUI_ID_LIT("__tab")), true, true);
 			if (input.clicked)
 			{
 				dock_select_panel(panel);
@@ -1272,6 +1642,7 @@ bool begin_panel(const char* name, Rect rect, PanelFlag flags)
 
 void end_panel()
 {
+	LGUI_PROFILE_ZONE("end_panel");
 	Panel* panel = get_current_panel();
 	Painter& painter = panel->get_painter();
 
@@ -1299,18 +1670,24 @@ void end_panel()
 	}
 
 	// Calculate missing box sizes
-	for (int i = 0; i < 2; ++i)
 	{
-		for (Box* it = panel->last_unknown_pc[i]; it; it = it->next_unknown_size[i])
+		LGUI_PROFILE_ZONE("post_calculate_percent");
+		for (int i = 0; i < 2; ++i)
 		{
-			it->post_calculate_percent(i);
+			for (Box* it = panel->last_unknown_pc[i]; it; it = it->next_unknown_size[i])
+			{
+				it->post_calculate_percent(i);
+			}
 		}
 	}
-	for (int i = 0; i < 2; ++i)
 	{
-		for (Box* it = panel->first_unknown_fit[i]; it; it = it->next_unknown_size[i])
+		LGUI_PROFILE_ZONE("post_calculate_fit");
+		for (int i = 0; i < 2; ++i)
 		{
-			it->post_calculate_fit(i);
+			for (Box* it = panel->first_unknown_fit[i]; it; it = it->next_unknown_size[i])
+			{
+				it->post_calculate_fit(i);
+			}
 		}
 	}
 
@@ -1342,6 +1719,10 @@ void end_panel()
 
 	// Draw boxes
 	_draw_boxes(painter, panel->root_box, panel->rect.top_left);
+	if (get_context()->layout_heat_map_active)
+	{
+		_draw_layout_heat_map(painter, panel);
+	}
 
 	// Store window size if resizable
 	if (panel->flags & PanelFlag_AutoResizeHorizontal)
@@ -1353,6 +1734,9 @@ void end_panel()
 		panel->rect.bottom_right.y = panel->rect.top_left.y + panel->root_box->calculated_size.y;
 	}
 
+	// Finish the last command before the previous window continues after it in the draw buffer
+	painter._push_command();
+
 	// Restart painter of previous window if it exists
 	Panel* prev_top_panel = try_get_prev_top_panel();
 	if (prev_top_panel)
@@ -1360,8 +1744,6 @@ void end_panel()
 		prev_top_panel->get_painter()._restart_painter();
 	}
 
-	painter._push_command();
-
 	pop_id();
 	pop_panel();
 }
@@ -1530,11 +1912,11 @@ void Box::update_t_linear(bool hover, bool active, f32 duration)
 	f32 hover_dir = hover ? 1.f : -1.f;
 	f32 active_dir = active ? 1.f : -1.f;
 
-	hover_t += hover_dir * dt * (1.f / duration);
-	hover_t = LGUI_CLAMP(0.f, 1.f, hover_t);
-	active_t += active_dir * dt * (1.f / duration);
-	active_t = LGUI_CLAMP(0.f, 1.f, active_t);
-
+	BoxDrawData* data = get_draw_data();
+	data->hover_t += hover_dir * dt * (1.f / duration);
+	data->hover_t = LGUI_CLAMP(0.f, 1.f, data->hover_t);
+	data->active_t += active_dir * dt * (1.f / duration);
+	data->active_t = LGUI_CLAMP(0.f, 1.f, data->active_t);
 }
 
 void Box::update_t_towards(bool hover, bool active, f32 rate)
@@ -1543,10 +1925,11 @@ void Box::update_t_towards(bool hover, bool active, f32 rate)
 	f32 hover_goal = hover ? 1.f : 0.f;
 	f32 active_goal = active ? 1.f : 0.f;
 
-	hover_t += (hover_goal - hover_t) * dt * rate;
-	hover_t = LGUI_CLAMP(0.f, 1.f, hover_t);
-	active_t += (active_goal - active_t) * dt * rate;
-	active_t = LGUI_CLAMP(0.f, 1.f, active_t);
+	BoxDrawData* data = get_draw_data();
+	data->hover_t += (hover_goal - data->hover_t) * dt * rate;
+	data->hover_t = LGUI_CLAMP(0.f, 1.f, data->hover_t);
+	data->active_t += (active_goal - data->active_t) * dt * rate;
+	data->active_t = LGUI_CLAMP(0.f, 1.f, data->active_t);
 }
 
 InputResult handle_element_input(Rect rect, ID id, bool enable_drag, bool ignore_clip)
@@ -1754,23 +2137,22 @@ RetainedData* get_retained_data(ID id)
 
 	Panel* panel = get_current_panel();
 
-	RetainedData** first_retained_data = &panel->retained_data_lookup[id % RETAINED_TABLE_SIZE];
-	for (RetainedData* it = *first_retained_data; it; it = it->next)
+	HandleStore<RetainedData>& store = context->retained_data_store;
+	if (Handle* handle = panel->retained_data_lookup.find(id))
 	{
-		if (it->id == id)
-		{
-			return it;
-		}
+		RetainedData* ret = store.get(*handle);
+		ret->frame_last_used = context->current_frame;
+		return ret;
 	}
 
-	RetainedData* retained_data = context->arena.allocate_one<RetainedData>();
+	Handle handle = store.create();
+	*panel->retained_data_lookup.insert(id) = handle;
+	RetainedData* retained_data = store.get(handle);
+	_track_allocation(context, AllocationType_RetainedData, sizeof(RetainedData));
+	panel->memory_stats.retained_data_count += 1;
+	panel->memory_stats.retained_data_frame_grown = context->current_frame;
 	retained_data->id = id;
-	retained_data->next = *first_retained_data;
-	if (*first_retained_data)
-	{
-		(*first_retained_data)->prev = retained_data;
-	}
-	*first_retained_data = retained_data;
+	retained_data->frame_last_used = context->current_frame;
 
 	return retained_data;
 }
@@ -1792,8 +2174,8 @@ void DrawBuffer::allocate()
 	vertex_buffer_top = 0;
 	index_buffer_top = 0;
 
-	vertex_buffer = (f32*)context->arena.allocate(short_max * vertex_size);
-	index_buffer = (DrawIndex*)context->arena.allocate(index_buffer_length * index_size);
+	vertex_buffer = (f32*)context->arena.allocate(short_max * vertex_size, CACHE_LINE_SIZE);
+	index_buffer = (DrawIndex*)context->arena.allocate(index_buffer_length * index_size, CACHE_LINE_SIZE);
 }
 
 ID box_generate_id()
@@ -1990,89 +2372,135 @@ void Box::post_calculate_fit(int index)
 	if (parent) parent->add_used_size(index, calc_size);
 }
 
-Box* _allocate_box(ID id)
+const char* _copy_temp_string(const char* str, usize length)
 {
 	Context* context = get_context();
-	Panel* panel = get_current_panel();
-
-	LGUI_ASSERT(panel->box_lookup[0] && panel->box_lookup[1], "Box lookup arrays not initialized");
-	Box** lookup_new = panel->box_lookup[context->current_frame % 2];
-	Box** lookup_old = panel->box_lookup[(context->current_frame - 1) % 2];
-
-	// Avoid memset when not needed by doing raw alloc
-	//Box* new_box = (Box*)context->temp_arena->allocate_raw(sizeof(Box));
-	Box* new_box = context->temp_arena->allocate_one<Box>();
+	_track_allocation(context, AllocationType_String, length + 1);
+	return copy_string(context->temp_arena, str, length);
+}
 
-	// Find box from previous frame
-	Box* old_box = nullptr;
-	if (context->box_next_expected->id == id)
+const char* _intern_string(const Label& label, const Font* font, f32* width)
+{
+	const char* str = label.text;
+	usize length = label.length;
+	if (length >= INTERNED_STRING_CAPACITY)
 	{
-		old_box = context->box_next_expected;
+		*width = font->text_width(str, length, 0.f);
+		return _copy_temp_string(str, length);
 	}
-	else
+
+	// The label was hashed when it was created
+	Context* context = get_context();
+	u32 hash = label.hash;
+	InternedString** first = context->interned_strings.insert(hash);
+
+	InternedString* string = nullptr;
+	for (InternedString* it = *first; it; it = it->next)
 	{
-		//for (Box* it = lookup_old[id & (BOX_TABLE_SIZE - 1)]; it; it = it->hash_next)
-		for (Box* it = lookup_old[id % BOX_TABLE_SIZE]; it; it = it->hash_next)
+		if (it->hash == hash && it->length == length && memcmp(it->text, str, length) == 0)
 		{
-			if (it->id == id)
-			{
-				old_box = it;
-				break;
-			}
+			string = it;
+			break;
 		}
 	}
 
-	if (old_box)
+	if (!string)
 	{
-		/*
-		*new_box = *old_box;
-		new_box->next = nullptr;
-		new_box->prev = nullptr;
-		new_box->parent = nullptr;
-		new_box->first_child = nullptr;
-		new_box->last_child = nullptr;
-		new_box->child_count = 0;
-		new_box->known_size_child_count[0] = 0;
-		new_box->known_size_child_count[1] = 0;
-		new_box->prev_used_size = new_box->used_size;
-		new_box->used_size = {};
-		new_box->static_size = {};
-		new_box->prev_calculated_position = new_box->calculated_position;
-		new_box->counter = 0;
-		new_box->is_size_calculated[0] = false;
-		new_box->is_size_calculated[1] = false;
-		new_box->next_unknown_size[0] = nullptr;
-		new_box->next_unknown_size[1] = nullptr;
-		// Keep calculated position/size so the user can reuse it
-		*/
+		string = context->interned_string_pool.allocate(&context->arena);
+		_track_allocation(context, AllocationType_InternedString, sizeof(InternedString));
+		string->hash = hash;
+		string->length = (u32)length;
+		memcpy(string->text, str, length);
+		string->text[length] = '\0';
 
-		new_box->id = id;
-		new_box->calculated_position = old_box->calculated_position;
-		new_box->calculated_size = old_box->calculated_size;
-		new_box->prev_calculated_position = old_box->calculated_position;
-		new_box->prev_used_size = old_box->used_size;
-		new_box->h_align = -1;
-		new_box->v_align = -1;
-		new_box->offset = old_box->offset;
-		new_box->hover_t = old_box->hover_t;
-		new_box->active_t = old_box->active_t;
-
-		new_box->prev_first_child = old_box->first_child;
-		new_box->prev_next = old_box->next;
+		string->next = *first;
+		*first = string;
+		++context->interned_string_count;
 	}
-	else
+
+	string->frame_last_used = context->current_frame;
+	if (string->width_font != font)
 	{
-		// Set fields to null since allocation can have trash data
-		//memset(new_box, 0, sizeof(Box));
-		new_box->id = id;
-		new_box->h_align = -1;
-		new_box->v_align = -1;
+		string->width = font->text_width(string->text, length, 0.f);
+		string->width_font = font;
 	}
+	*width = string->width;
+	return string->text;
+}
+
+// The box is allocated without zeroing, so _allocate_box must write every field
+// The size check makes a new Box field fail here instead of staying uninitialized, update it after writing the field
+// Size on 64-bit targets (premake builds x64 only), checked with GCC on x86-64, MSVC x64 lays the fields out the same way
+static_assert(sizeof(void*) != 8 || sizeof(Box) == 208, "Box changed, write its new fields in _allocate_box");
+
+Box* _allocate_box(ID id)
+{
+	Context* context = get_context();
+	Panel* panel = get_current_panel();
 
-	// Insert box in new frame
-	u32 index = id % BOX_TABLE_SIZE;
-	new_box->hash_next = lookup_new[index];
-	lookup_new[index] = new_box;
+	BoxLookup* lookup_new = &panel->box_lookup[context->current_frame % 2];
+	BoxLookup* lookup_old = &panel->box_lookup[(context->current_frame - 1) % 2];
+
+	// Find box from previous frame
+	Box* old_box = nullptr;
+	if (context->box_next_expected->id == id)
+	{
+		old_box = context->box_next_expected;
+	}
+	else
+	{
+		old_box = _find_box(context, lookup_old, id);
+	}
+
+	// Packed at 208 bytes, cache line alignment would pad every box to 256
+	Box* new_box = context->temp_arena->allocate_one_raw<Box>();
+	_track_allocation(context, AllocationType_Box, sizeof(Box));
+
+	// Every field is written exactly once, keeping the calculated position/size of the previous frame so the user can reuse it
+	new_box->parent = nullptr;
+	new_box->next = nullptr;
+	new_box->prev = nullptr;
+	new_box->first_child = nullptr;
+	new_box->last_child = nullptr;
+	new_box->prev_first_child = old_box ? old_box->first_child : nullptr;
+	new_box->prev_next = old_box ? old_box->next : nullptr;
+	new_box->next_unknown_size[0] = nullptr;
+	new_box->next_unknown_size[1] = nullptr;
+	new_box->prev_allocated = lookup_new->last_allocated;
+	new_box->id = id;
+	new_box->flags = 0;
+	new_box->counter = 0;
+	new_box->spacing = 0.f;
+	new_box->padding = {};
+	new_box->h_align = -1;
+	new_box->v_align = -1;
+	new_box->size[0] = {};
+	new_box->size[1] = {};
+	new_box->calculated_size = old_box ? old_box->calculated_size : v2{};
+	new_box->is_size_calculated[0] = false;
+	new_box->is_size_calculated[1] = false;
+	new_box->used_size = {};
+	new_box->prev_used_size = old_box ? old_box->used_size : v2{};
+	new_box->static_size = {};
+	new_box->child_count = 0;
+	new_box->known_size_child_count[0] = 0;
+	new_box->known_size_child_count[1] = 0;
+	new_box->calculated_position = old_box ? old_box->calculated_position : v2{};
+	new_box->prev_calculated_position = new_box->calculated_position;
+	new_box->offset = old_box ? old_box->offset : v2{};
+	new_box->draw_data = nullptr;
+
+	if (old_box && old_box->draw_data)
+	{
+		// Only the animation carries over, the styling is set again every frame
+		BoxDrawData* draw_data = new_box->get_draw_data();
+		draw_data->hover_t = old_box->draw_data->hover_t;
+		draw_data->active_t = old_box->draw_data->active_t;
+	}
+
+	// Add box to the new frame
+	lookup_new->last_allocated = new_box;
+	++lookup_new->box_count;
 
 	return new_box;
 }
@@ -2087,6 +2515,9 @@ void _init_box(Box* box, Size2 size, u32 flags)
 
 Box* make_box(ID id, Size2 size, u32 flags)
 {
+	Context* context = get_context();
+	u64 heat_start_ns = context->layout_heat_map_active ? get_time_ns() : 0;
+
 	Box* box = _allocate_box(id);
 
 	_init_box(box, size, flags);
@@ -2099,7 +2530,11 @@ Box* make_box(ID id, Size2 size, u32 flags)
 		box->end();
 	}
 
-	Context* context = get_context();
+	if (context->layout_heat_map_active)
+	{
+		box->get_draw_data()->heat_layout_ns = (u32)(get_time_ns() - heat_start_ns);
+	}
+
 	static Box null_box{};
 	context->box_next_expected = box->prev_next ? box->prev_next : &null_box;
 
@@ -2123,6 +2558,11 @@ void push_box(Box* box)
 		parent->append_child(box);
 	}
 
+	if (context->layout_heat_map_active)
+	{
+		box->get_draw_data()->heat_start_ns = get_time_ns();
+	}
+
 	box->begin();
 
 	LGUI_ASSERT(context->box_stack_top < BOX_STACK_SIZE, "Box stack out of bounds");
@@ -2161,6 +2601,17 @@ Box* pop_box()
 
 	pop->end();
 
+	if (context->layout_heat_map_active)
+	{
+		BoxDrawData* data = pop->get_draw_data();
+		data->heat_layout_ns = (u32)(get_time_ns() - data->heat_start_ns);
+		data->descendant_count = 0;
+		for (Box* it = pop->first_child; it; it = it->next)
+		{
+			data->descendant_count += it->get_draw_data()->descendant_count + 1;
+		}
+	}
+
 	pop_id();
 
 	static Box null_box{};
@@ -2198,58 +2649,77 @@ void layout_end()
 	pop_box();
 }
 
+BoxDrawData* Box::get_draw_data()
+{
+	if (!draw_data)
+	{
+		Context* context = get_context();
+		draw_data = context->temp_arena->allocate_one<BoxDrawData>();
+		_track_allocation(context, AllocationType_BoxDrawData, sizeof(BoxDrawData));
+	}
+	return draw_data;
+}
+
 void Box::set_rectangle(Color color)
 {
 	flags |= BoxFlag_DrawRectangle;
-	this->color = color;
-	this->outline_color = {};
-	this->outline_size = 0;
+	BoxDrawData* data = get_draw_data();
+	data->color = color;
+	data->outline_color = {};
+	data->outline_size = 0;
 }
 
 void Box::set_rectangle(Color color, Color outline_color, f32 outline_size)
 {
 	flags |= BoxFlag_DrawRectangle;
-	this->color = color;
-	this->outline_color = outline_color;
-	this->outline_size = outline_size;
+	BoxDrawData* data = get_draw_data();
+	data->color = color;
+	data->outline_color = outline_color;
+	data->outline_size = outline_size;
 }
 
 void Box::set_circle(Color color)
 {
 	flags |= BoxFlag_DrawCircle;
-	this->color = color;
-	this->outline_color = {};
-	this->outline_size = 0;
+	BoxDrawData* data = get_draw_data();
+	data->color = color;
+	data->outline_color = {};
+	data->outline_size = 0;
 }
 
 void Box::set_circle(Color color, Color outline_color, f32 outline_size)
 {
 	flags |= BoxFlag_DrawCircle;
-	this->color = color;
-	this->outline_color = outline_color;
-	this->outline_size = outline_size;
+	BoxDrawData* data = get_draw_data();
+	data->color = color;
+	data->outline_color = outline_color;
+	data->outline_size = outline_size;
 }
 
 void Box::set_draw_hook(void* ud, DrawHook hook)
 {
 	LGUI_ASSERT(hook, "Hook cannot be null");
 	flags |= BoxFlag_DrawHook;
-	this->draw_hook = hook;
-	this->draw_user_data = ud;
+	BoxDrawData* data = get_draw_data();
+	data->draw_hook = hook;
+	data->draw_user_data = ud;
 }
 
 void Box::set_draw_hook(DrawHook hook)
 {
 	LGUI_ASSERT(hook, "Hook cannot be null");
 	flags |= BoxFlag_DrawHook;
-	this->draw_hook = hook;
-	this->draw_user_data = nullptr;
+	BoxDrawData* data = get_draw_data();
+	data->draw_hook = hook;
+	data->draw_user_data = nullptr;
 }
 
 static void _draw_box(Painter& painter, Box* box, const Rect* clip_rect)
 {
 	// Position must already be known here
 
+	u64 heat_start_ns = get_context()->layout_heat_map_active ? get_time_ns() : 0;
+
 	// Optimization avoiding get_clip_rect
 	Rect pass_clip_rect;
 
@@ -2259,43 +2729,48 @@ static void _draw_box(Painter& painter, Box* box, const Rect* clip_rect)
 
 	if (box->flags & BoxFlag_AnyDrawFlags && clip_rect->overlap(rect))
 	{
+		// Draw flags without any styling draw with zeroed styling
+		static const BoxDrawData null_draw_data{};
+		const BoxDrawData* data = box->draw_data ? box->draw_data : &null_draw_data;
+
 		if (box->flags & BoxFlag_DrawRectangle)
 		{
-			if (box->outline_size > 0.f)
+			if (data->outline_size > 0.f)
 			{
-				v2 outline = { box->outline_size, box->outline_size };
-				painter.draw_rectangle(box->calculated_position, box->calculated_size, box->outline_color);
-				painter.draw_rectangle(box->calculated_position + outline, box->calculated_size - outline * 2.f, box->color);
+				v2 outline = { data->outline_size, data->outline_size };
+				painter.draw_rectangle(box->calculated_position, box->calculated_size, data->outline_color);
+				painter.draw_rectangle(box->calculated_position + outline, box->calculated_size - outline * 2.f, data->color);
 			}
 			else
 			{
-				painter.draw_rectangle(box->calculated_position, box->calculated_size, box->color);
+				painter.draw_rectangle(box->calculated_position, box->calculated_size, data->color);
 			}
 		}
 		if (box->flags & BoxFlag_DrawCircle)
 		{
 			v2 size = { box->calculated_size.x, box->calculated_size.x };
-			if (box->outline_size > 0.f)
+			if (data->outline_size > 0.f)
 			{
-				painter.draw_circle(box->calculated_position + size / 2.f, box->calculated_size.x / 2.f, 1.f, box->outline_color);
-				painter.draw_circle(box->calculated_position + size / 2.f, box->calculated_size.x / 2.f - box->outline_size, 1.f, box->color);
+				painter.draw_circle(box->calculated_position + size / 2.f, box->calculated_size.x / 2.f, 1.f, data->outline_color);
+				painter.draw_circle(box->calculated_position + size / 2.f, box->calculated_size.x / 2.f - data->outline_size, 1.f, data->color);
 			}
 			else
 			{
-				painter.draw_circle(box->calculated_position + size / 2.f, box->calculated_size.x / 2.f, 1.f, box->color);
+				painter.draw_circle(box->calculated_position + size / 2.f, box->calculated_size.x / 2.f, 1.f, data->color);
 			}
 		}
 		if (box->flags & BoxFlag_DrawHook)
 		{
-			LGUI_ASSERT(box->draw_hook, "No draw hook provided");
-			box->draw_hook(box, painter, rect);
+			LGUI_ASSERT(data->draw_hook, "No draw hook provided");
+			data->draw_hook(box, painter, rect);
 		}
 		if (box->flags & BoxFlag_DrawText)
 		{
-			LGUI_ASSERT(box->font, "Box wants to render text but has not font");
-			v2 text_size = {box->font->text_width(box->text, box->text_length, 0.f), box->font->height};
+			LGUI_ASSERT(data->font, "Box wants to render text but has not font");
+			f32 text_width = data->text_width > 0.f ? data->text_width : data->font->text_width(data->text, data->text_length, 0.f);
+			v2 text_size = {text_width, data->font->height};
 			Rect r = rect.align_size(text_size, box->h_align, box->v_align);
-			painter.draw_text(box->font, box->text, box->text_length, r.top_left, 0.f, box->text_color);
+			painter.draw_text(data->font, data->text, data->text_length, r.top_left, 0.f, data->text_color);
 		}
 	}
 	if (box->flags & BoxFlag_Clip)
@@ -2491,20 +2966,113 @@ static void _draw_box(Painter& painter, Box* box, const Rect* clip_rect)
 
 	//debug_rect(rect, "lol", {1, 1, 0, 1});
 	//debug_rect(rect, " ", {0, 1, 0, 1});
+
+	if (heat_start_ns)
+	{
+		box->get_draw_data()->heat_draw_ns = (u32)(get_time_ns() - heat_start_ns);
+	}
 }
 
 static void _draw_boxes(Painter& painter, Box* root, v2 start_pos)
 {
+	LGUI_PROFILE_ZONE("_draw_box");
 	root->calculated_position = start_pos;
 	Rect clip_rect = painter.get_clip_rect();
 	_draw_box(painter, root, &clip_rect);
 }
 
+static void _draw_layout_heat_map_box(Painter& painter, Box* box, u32 max_ns, Box** hovered)
+{
+	Rect rect = box->prev_rect();
+	BoxDrawData* data = box->get_draw_data();
+	f32 t = (f32)(data->heat_layout_ns + data->heat_draw_ns) / (f32)max_ns;
+	t = LGUI_CLAMP(0.f, 1.f, t);
+	painter.draw_rectangle(rect, {t, 1.f - t, 0.f, 0.05f + 0.35f * t});
+
+	// Children are visited later, so the innermost box under the mouse wins
+	if (hovered && rect.overlap(mouse_pos()))
+	{
+		*hovered = box;
+	}
+
+	for (Box* it = box->first_child; it; it = it->next)
+	{
+		_draw_layout_heat_map_box(painter, it, max_ns, hovered);
+	}
+}
+
+// Tints the boxes of a panel by their cost relative to the root box, on top of the content
+static void _draw_layout_heat_map(Painter& painter, Panel* panel)
+{
+	Box* root = panel->root_box;
+	BoxDrawData* root_data = root->get_draw_data();
+	u32 max_ns = LGUI_MAX(root_data->heat_layout_ns + root_data->heat_draw_ns, 1u);
+
+	Box* hovered = nullptr;
+	_draw_layout_heat_map_box(painter, root, max_ns, panel->rect.overlap(mouse_pos()) ? &hovered : nullptr);
+	if (!hovered)
+	{
+		return;
+	}
+
+	Font* font = get_style().default_font;
+	char lines[2][64];
+	snprintf(lines[0], sizeof(lines[0]), "layout %.2f us, draw %.2f us",
+		(f32)hovered->draw_data->heat_layout_ns / 1000.f, (f32)hovered->draw_data->heat_draw_ns / 1000.f);
+	snprintf(lines[1], sizeof(lines[1]), "%u descendants", hovered->draw_data->descendant_count);
+
+	v2 pos = mouse_pos() + v2{12.f, 12.f};
+	f32 width = LGUI_MAX(font->text_width(lines[0], 0.f), font->text_width(lines[1], 0.f));
+	painter.draw_rectangle_outline(hovered->prev_rect(), 1.f, {1.f, 1.f, 1.f, 1.f});
+	painter.draw_rectangle(Rect::from_pos_size(pos, {width + 8.f, font->height * 2.f + 8.f}), {0.f, 0.f, 0.f, 0.8f});
+	painter.draw_text(font, lines[0], pos + v2{4.f, 4.f}, 0.f, {1.f, 1.f, 1.f, 1.f});
+	painter.draw_text(font, lines[1], pos + v2{4.f, 4.f + font->height}, 0.f, {1.f, 1.f, 1.f, 1.f});
+}
+
+void layout_heat_map_set_enabled(bool enabled)
+{
+	get_context()->layout_heat_map_enabled = enabled;
+}
+
+bool layout_heat_map_is_enabled()
+{
+	return get_context()->layout_heat_map_enabled;
+}
+
+static void _append_dock_tab_names(Dock* dock, char* buffer, usize buffer_size, usize* length, usize first_length)
+{
+	for (Panel* tab = dock->first_tab; tab; tab = tab->next_dock_tab)
+	{
+		int written = snprintf(buffer + *length, buffer_size - *length, *length == first_length ? "%s" : ", %s", tab->name);
+		*length = LGUI_MIN(*length + (usize)LGUI_MAX(written, 0), buffer_size - 1);
+	}
+	for (int i = 0; i < 2; ++i)
+	{
+		if (dock->child_docks[i])
+		{
+			_append_dock_tab_names(dock->child_docks[i], buffer, buffer_size, length, first_length);
+		}
+	}
+}
+
+const char* get_panel_debug_name(Panel* panel, char* buffer, usize buffer_size)
+{
+	if (!panel->is_dock_root)
+	{
+		return copy_string_to_buffer(buffer, buffer_size, panel->name);
+	}
+
+	int written = snprintf(buffer, buffer_size, "dock: ");
+	usize length = LGUI_MIN((usize)LGUI_MAX(written, 0), buffer_size - 1);
+	_append_dock_tab_names(panel->parent_dock, buffer, buffer_size, &length, length);
+	return buffer;
+}
+
 void debug_menu()
 {
 	Context* context = get_context();
 
-	if (begin_panel("Debug Window", Rect::from_pos_size({}, {400, 300}), 0))
+	if (begin_window("Debug Window", Rect::from_pos_size({}, {400, 300}), 0))
 	{
 		const int buffer_size = 64;
 		char buffer[buffer_size]{};
@@ -2539,7 +3107,227 @@ void debug_menu()
 #endif
 	*/
 
-		end_panel();
+#ifdef LGUI_PROFILER
+		if (begin_tree_node("Profiler"))
+		{
+			LGUI_H_LAYOUT(-1, 0)
+			{
+				checkbox("profiler_enabled", &context->profiler.enabled);
+				spacer(2.f);
+				text("Enabled");
+			}
+			spacer(2.f);
+			if (button("Export Chrome trace").clicked)
+			{
+				profiler_export_chrome_trace("lgui_trace.json");
+			}
+			spacer(2.f);
+			draw_hook(px(360.f, 160.f), [](Box*, Painter& painter, Rect rect) {
+				profiler_draw_flame_graph(painter, rect);
+			});
+			end_tree_node();
+		}
+#endif
+
+		if (begin_tree_node("Layout"))
+		{
+			LGUI_H_LAYOUT(-1, 0)
+			{
+				checkbox("layout_heat_map", &context->layout_heat_map_enabled);
+				spacer(2.f);
+				text("Heat map");
+			}
+			end_tree_node();
+		}
+
+		if (begin_tree_node("Memory"))
+		{
+			const char* type_names[AllocationType_COUNT] = {
+				"Box", "DrawCommand", "RetainedData", "Panel", "String", "BoxLookup", "BoxDrawData", "InternedString",
+			};
+			const MemoryStats& stats = context->memory_stats;
+			const f32 kb = 1.f / 1024.f;
+
+			textf("arena: %.1f KB used, %.1f KB high water, %.1f KB size, %.1f KB reserved",
+				(f32)context->arena.used * kb, (f32)context->arena.high_water * kb, (f32)context->arena.length * kb,
+				(f32)context->arena.reserved * kb);
+			for (u32 i = 0; i < 2; ++i)
+			{
+				const Arena& arena = context->temp_arena_arr[i];
+				textf("temp_arena[%u]: %.1f KB per frame, %.1f KB high water, %.1f KB size, %.1f KB reserved",
+					i, (f32)stats.temp_arena_frame_used[i] * kb, (f32)arena.high_water * kb, (f32)arena.length * kb,
+					(f32)arena.reserved * kb);
+			}
+			for (u32 i = 0; i < SCRATCH_ARENA_COUNT; ++i)
+			{
+				const Arena& arena = context->scratch_arenas[i];
+				textf("scratch_arenas[%u]: %.1f KB high water, %.1f KB size, %.1f KB reserved",
+					i, (f32)arena.high_water * kb, (f32)arena.length * kb, (f32)arena.reserved * kb);
+			}
+			textf("pools (objects created): %u Panel, %u DrawCommand, %u InternedString",
+				context->panel_pool.created, context->draw_command_pool.created, context->interned_string_pool.created);
+			const HandleStore<RetainedData>& retained_store = context->retained_data_store;
+			textf("retained data store: %u live, %u holes, %u handles, %.1f KB committed",
+				retained_store.object_count - retained_store.hole_count, retained_store.hole_count, retained_store.slot_count,
+				(f32)(retained_store.slots.length + retained_store.objects.length + retained_store.owners.length) * kb);
+			textf("interned strings: %u live", context->interned_string_count);
+			separator();
+			text("Allocations last frame (total since init)");
+			for (u32 i = 0; i < AllocationType_COUNT; ++i)
+			{
+				textf("%s: %u, %.1f KB (%u, %.1f KB)", type_names[i],
+					stats.prev_frame[i].count, (f32)stats.prev_frame[i].bytes * kb,
+					stats.total[i].count, (f32)stats.total[i].bytes * kb);
+			}
+			separator();
+
+			// Per panel, last frame except for the retained data which is alive
+			const BlockAllocator& blocks = context->hash_map_blocks;
+			textf("Per panel (hash map arrays of all panels: %.1f KB, %.1f KB free)", (f32)blocks.allocated * kb, (f32)blocks.free_bytes * kb);
+			const char* column_names[] = {"Panel", "Retained", "Grown", "Evicted", "Boxes KB", "Lookup KB", "Commands", "Strings KB"};
+			const f32 column_widths[] = {110.f, 55.f, 55.f, 55.f, 60.f, 60.f, 60.f, 65.f};
+			const f32 row_height = get_style().default_font->height;
+			LGUI_H_LAYOUT(-1, 0)
+			{
+				for (u32 i = 0; i < LGUI_ARRAY_SIZE(column_names); ++i)
+				{
+					text(column_names[i], px(column_widths[i], row_height), i == 0 ? -1 : 1);
+				}
+			}
+			// The panel map also has the docked tabs, they are not in the depth list
+			char name[64];
+			for (u32 i = 0; i < context->panel_map.capacity; ++i)
+			{
+				if (!context->panel_map.entries[i].used) continue;
+				Panel* it = context->panel_map.entries[i].value;
+				const PanelMemoryStats& panel_stats = it->memory_stats;
+				LGUI_H_LAYOUT(-1, 0)
+				{
+					text(get_panel_debug_name(it, name, sizeof(name)), px(column_widths[0], row_height), -1);
+					snprintf(buffer, buffer_size, "%u", panel_stats.retained_data_count);
+					text(buffer, px(column_widths[1], row_height), 1);
+					// Frames since the last new retained data
+					snprintf(buffer, buffer_size, "%u", context->current_frame - panel_stats.retained_data_frame_grown);
+					text(buffer, px(column_widths[2], row_height), 1);
+					snprintf(buffer, buffer_size, "%u", panel_stats.retained_data_evicted);
+					text(buffer, px(column_widths[3], row_height), 1);
+					snprintf(buffer, buffer_size, "%.1f", (f32)panel_stats.prev_frame[AllocationType_Box].bytes * kb);
+					text(buffer, px(column_widths[4], row_height), 1);
+					snprintf(buffer, buffer_size, "%.1f", (f32)panel_stats.prev_frame[AllocationType_BoxLookup].bytes * kb);
+					text(buffer, px(column_widths[5], row_height), 1);
+					snprintf(buffer, buffer_size, "%u", panel_stats.prev_frame[AllocationType_DrawCommand].count);
+					text(buffer, px(column_widths[6], row_height), 1);
+					snprintf(buffer, buffer_size, "%.1f", (f32)panel_stats.prev_frame[AllocationType_String].bytes * kb);
+					text(buffer, px(column_widths[7], row_height), 1);
+				}
+			}
+			end_tree_node();
+		}
+
+		if (begin_tree_node("Draw"))
+		{
+			const DrawStats& frame = context->draw_buffer.prev_stats;
+			textf("Frame: %u vertices (%.1f%% of DRAW_INDEX_MAX), %u triangles",
+				frame.vertices, (f32)frame.vertices / (f32)DRAW_INDEX_MAX * 100.f, frame.triangles);
+			textf("%u commands, %u clip rects, %u draw calls", frame.commands, frame.clip_rect_pushes, frame.draw_calls);
+			if (frame.dropped_draws)
+			{
+				textf("%u draws dropped, the draw buffer is full", frame.dropped_draws);
+			}
+			separator();
+
+			// Per panel table, click a column header to sort on it (again to reverse)
+			static u32 sort_column = 1;
+			static bool sort_ascending = false;
+			const char* column_names[] = {"Panel", "Vertices", "Triangles", "Commands", "Clips", "Calls", "Dropped"};
+			const f32 column_widths[] = {110.f, 60.f, 60.f, 60.f, 45.f, 45.f, 55.f};
+			const f32 row_height = get_style().default_font->height;
+
+			LGUI_H_LAYOUT(-1, 0)
+			{
+				for (u32 i = 0; i < LGUI_ARRAY_SIZE(column_names); ++i)
+				{
+					if (button(column_names[i], px(column_widths[i], row_height + 4.f)).clicked)
+					{
+						sort_ascending = sort_column == i ? !sort_ascending : i == 0;
+						sort_column = i;
+					}
+				}
+			}
+
+			// Collect the panels that are rendered
+			// Docked tabs draw with the painter of their dock root, its row is named after the tabs
+			struct PanelRow {
+				Panel* panel;
+				char name[64];
+			};
+			u32 panel_count = 0;
+			for (Panel* it = context->first_depth_panel; it; it = it->order_next)
+			{
+				++panel_count;
+			}
+			Slice<PanelRow> rows = context->temp_arena->allocate_array<PanelRow>(panel_count);
+			panel_count = 0;
+			for (Panel* it = context->first_depth_panel; it; it = it->order_next)
+			{
+				PanelRow& row = rows[panel_count++];
+				row.panel = it;
+				get_panel_debug_name(it, row.name, sizeof(row.name));
+			}
+
+			auto column_value = [](Panel* panel, u32 column) -> u32 {
+				const DrawStats& stats = panel->painter.get_completed_stats();
+				switch (column)
+				{
+				case 1: return stats.vertices;
+				case 2: return stats.triangles;
+				case 3: return stats.commands;
+				case 4: return stats.clip_rect_pushes;
+				case 5: return stats.draw_calls;
+				case 6: return stats.dropped_draws;
+				}
+				return 0;
+			};
+			auto less = [&](const PanelRow* a, const PanelRow* b) {
+				if (!sort_ascending)
+				{
+					const PanelRow* temp = a;
+					a = b;
+					b = temp;
+				}
+				return sort_column == 0 ?
+					strcmp(a->name, b->name) < 0 :
+					column_value(a->panel, sort_column) < column_value(b->panel, sort_column);
+			};
+
+			// Insertion sort, there are only a handful of panels
+			for (u32 i = 1; i < panel_count; ++i)
+			{
+				PanelRow row = rows[i];
+				u32 j = i;
+				for (; j > 0 && less(&row, &rows[j - 1]); --j)
+				{
+					rows[j] = rows[j - 1];
+				}
+				rows[j] = row;
+			}
+
+			for (u32 i = 0; i < panel_count; ++i)
+			{
+				LGUI_H_LAYOUT(-1, 0)
+				{
+					text(rows[i].name, px(column_widths[0], row_height), -1);
+					for (u32 column = 1; column < LGUI_ARRAY_SIZE(column_names); ++column)
+					{
+						snprintf(buffer, buffer_size, "%u", column_value(rows[i].panel, column));
+						text(buffer, px(column_widths[column], row_height), 1);
+					}
+				}
+			}
+			end_tree_node();
+		}
+
+		end_window();
 	}
 }
 
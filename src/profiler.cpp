@@ -0,0 +1,204 @@
+#include "lag_gui.hpp"
+#include "basic.hpp"
+#include <stdio.h>
+
+#ifdef LGUI_PROFILER
+
+namespace lgui {
+
+const usize PROFILE_DEPTH_MAX = 64;
+
+void profiler_set_enabled(bool enabled)
+{
+	get_context()->profiler.enabled = enabled;
+}
+
+bool profiler_is_enabled()
+{
+	return get_context()->profiler.enabled;
+}
+
+void _profiler_begin_frame()
+{
+	Context* context = get_context();
+	Profiler& profiler = context->profiler;
+
+	u64 now = get_time_ns();
+
+	profiler.prev_markers = profiler.markers;
+	profiler.prev_marker_count = profiler.marker_count;
+	profiler.prev_frame_start_ns = profiler.frame_start_ns;
+	profiler.prev_frame_end_ns = now;
+
+	// The new temporary arena has just been reset, the previous one stays valid for this frame
+	// Raw allocation, markers are always written before they are read
+	profiler.markers = profiler.enabled ?
+		(ProfileMarker*)context->temp_arena->allocate_raw(sizeof(ProfileMarker) * PROFILE_MARKER_MAX) : nullptr;
+	profiler.marker_count = 0;
+	profiler.frame_start_ns = now;
+}
+
+static void _push_marker(const char* name, bool is_end)
+{
+	Profiler& profiler = get_context()->profiler;
+	if (!profiler.enabled || !profiler.markers)
+	{
+		return;
+	}
+
+	ProfileMarker& marker = profiler.markers[profiler.marker_count % PROFILE_MARKER_MAX];
+	marker.name = name;
+	marker.is_end = is_end;
+	marker.time_ns = get_time_ns();
+	++profiler.marker_count;
+}
+
+void profiler_begin_zone(const char* name)
+{
+	_push_marker(name, false);
+}
+
+void profiler_end_zone()
+{
+	_push_marker(nullptr, true);
+}
+
+// Calls fn(name, start_ns, end_ns, depth) for every complete zone of the previous frame
+template<typename F>
+static void _for_each_prev_zone(F fn)
+{
+	Profiler& profiler = get_context()->profiler;
+	if (!profiler.prev_markers)
+	{
+		return;
+	}
+
+	u32 count = profiler.prev_marker_count;
+	u32 first = count > PROFILE_MARKER_MAX ? count - (u32)PROFILE_MARKER_MAX : 0;
+
+	const ProfileMarker* stack[PROFILE_DEPTH_MAX];
+	u32 depth = 0;
+	for (u32 i = first; i < count; ++i)
+	{
+		const ProfileMarker& marker = profiler.prev_markers[i % PROFILE_MARKER_MAX];
+		if (!marker.is_end)
+		{
+			if (depth < PROFILE_DEPTH_MAX)
+			{
+				stack[depth] = &marker;
+			}
+			++depth;
+		}
+		else if (depth > 0)
+		{
+			// End markers without a begin marker were overwritten by the ring buffer and are skipped
+			--depth;
+			if (depth < PROFILE_DEPTH_MAX)
+			{
+				fn(stack[depth]->name, stack[depth]->time_ns, marker.time_ns, depth);
+			}
+		}
+	}
+}
+
+bool profiler_export_chrome_trace(const char* filename)
+{
+	Profiler& profiler = get_context()->profiler;
+
+	FILE* file;
+	if (fopen_s(&file, filename, "wb"))
+	{
+		return false;
+	}
+
+	u64 base = profiler.prev_frame_start_ns;
+
+	fprintf(file, "{\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"frame\",\"ph\":\"X\",\"ts\":0,\"dur\":%.3f,\"pid\":0,\"tid\":0}",
+		(f64)(profiler.prev_frame_end_ns - base) / 1000.0);
+	_for_each_prev_zone([&](const char* name, u64 start_ns, u64 end_ns, u32) {
+		fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":0}",
+			name, (f64)(start_ns - base) / 1000.0, (f64)(end_ns - start_ns) / 1000.0);
+	});
+	fprintf(file, "\n]}\n");
+
+	fclose(file);
+	return true;
+}
+
+void _profiler_write_prev_zones(void* file)
+{
+	Profiler& profiler = get_context()->profiler;
+	u64 base = profiler.prev_frame_start_ns;
+
+	// Zones are reported when they end, so children come before their parent
+	_for_each_prev_zone([&](const char* name, u64 start_ns, u64 end_ns, u32 depth) {
+		fprintf((FILE*)file, "%*s%s: start %.2f us, %.2f us\n", (int)depth * 2, "",
+			name, (f64)(start_ns - base) / 1000.0, (f64)(end_ns - start_ns) / 1000.0);
+	});
+}
+
+void profiler_draw_flame_graph(Painter& painter, Rect rect)
+{
+	Profiler& profiler = get_context()->profiler;
+
+	const f32 row_height = 16.f;
+	Color background = {0.1f, 0.1f, 0.1f, 1.f};
+	Color text_color = {1.f, 1.f, 1.f, 1.f};
+	Color colors[] = {
+		{0.8f, 0.3f, 0.2f, 1.f},
+		{0.8f, 0.6f, 0.2f, 1.f},
+		{0.3f, 0.6f, 0.3f, 1.f},
+		{0.2f, 0.5f, 0.8f, 1.f},
+	};
+
+	painter.draw_rectangle(rect, background);
+
+	u64 base = profiler.prev_frame_start_ns;
+	f64 duration = (f64)(profiler.prev_frame_end_ns - base);
+	if (duration <= 0.0)
+	{
+		return;
+	}
+
+	Font* font = get_style().default_font;
+	v2 mouse = mouse_pos();
+	const char* hover_name = nullptr;
+	u64 hover_ns = 0;
+
+	painter.push_clip_rect(rect);
+	_for_each_prev_zone([&](const char* name, u64 start_ns, u64 end_ns, u32 depth) {
+		f32 x1 = rect.top_left.x + (f32)((f64)(start_ns - base) / duration) * rect.width();
+		f32 x2 = rect.top_left.x + (f32)((f64)(end_ns - base) / duration) * rect.width();
+		Rect zone = Rect::from_2_pos(
+			{x1, rect.top_left.y + depth * row_height},
+			{LGUI_MAX(x2, x1 + 1.f), rect.top_left.y + (depth + 1) * row_height - 1.f}
+		);
+
+		painter.draw_rectangle(zone, colors[depth % LGUI_ARRAY_SIZE(colors)]);
+		if (font->text_width(name, 0.f) < zone.width())
+		{
+			painter.draw_text(font, name, zone.top_left, 0.f, text_color);
+		}
+
+		if (zone.overlap(mouse))
+		{
+			hover_name = name;
+			hover_ns = end_ns - start_ns;
+		}
+	});
+
+	if (hover_name)
+	{
+		char buffer[128];
+		snprintf(buffer, sizeof(buffer), "%s: %.2f us", hover_name, (f64)hover_ns / 1000.0);
+		v2 pos = mouse + v2{10.f, 0.f};
+		painter.draw_rectangle(Rect::from_pos_size(pos, {font->text_width(buffer, 0.f), font->height}), background);
+		painter.draw_text(font, buffer, pos, 0.f, text_color);
+	}
+	painter.pop_clip_rect();
+}
+
+}
+
+#endif
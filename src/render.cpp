@@ -7,8 +7,30 @@
 
 namespace lgui {
 
-const usize VERTEX_SIZE_BYTES = sizeof(f32) * 4 + sizeof(u32);
-const usize VERTEX_SIZE_FLOATS = 5;
+void DrawStats::add_command(const DrawCommand* command)
+{
+	vertices += (u32)((command->vertex_end - command->vertex_start) / VERTEX_SIZE_FLOATS);
+	triangles += (u32)((command->index_end - command->index_start) / 3);
+	commands += 1;
+}
+
+// Commands come from the pool without zeroing, this writes every field once
+static void _init_draw_command(DrawCommand* command, DrawCommand* prev, Rect clip_rect, TextureID texture_id, u32 layout_depth, bool is_layout)
+{
+	const DrawBuffer& buffer = get_context()->draw_buffer;
+	*command = DrawCommand{
+		nullptr,
+		prev,
+		clip_rect,
+		buffer.vertex_buffer_top,
+		buffer.vertex_buffer_top,
+		buffer.index_buffer_top,
+		buffer.index_buffer_top,
+		texture_id,
+		layout_depth,
+		is_layout,
+	};
+}
 
 void Painter::_push_command()
 {
@@ -33,18 +55,14 @@ void Painter::_push_command()
 	context->draw_buffer.vertex_buffer_top = current_command->vertex_end;
 	context->draw_buffer.index_buffer_top = current_command->index_end;
 
+	stats.add_command(command);
+	context->draw_buffer.stats.add_command(command);
+
 	// Reset current command
-	current_command = context->temp_arena->allocate_one<DrawCommand>();
+	current_command = context->draw_command_pool.allocate_raw(&context->arena);
+	_track_allocation(context, AllocationType_DrawCommand, sizeof(DrawCommand));
+	_init_draw_command(current_command, command, command->clip_rect, command->texture_id, command->layout_depth, command->is_layout);
 	command->next = current_command;
-	current_command->prev = command;
-	current_command->clip_rect = command->clip_rect;
-	current_command->is_layout = command->is_layout;
-	current_command->layout_depth = command->layout_depth;
-	current_command->vertex_start = context->draw_buffer.vertex_buffer_top;
-	current_command->vertex_end = current_command->vertex_start;
-	current_command->index_start = context->draw_buffer.index_buffer_top;
-	current_command->index_end = current_command->index_start;
-	current_command->texture_id = command->texture_id;
 
 	if (!first_command)
 	{
@@ -68,15 +86,15 @@ void Painter::_start_painter()
 	{
 		frame_last_updated = context->current_frame;
 
-		first_command = nullptr;
-		last_command = nullptr;
+		prev_stats = stats;
+		stats = {};
 
-		current_command = context->temp_arena->allocate_one<DrawCommand>();
-		current_command->clip_rect = get_clip_rect();
-		current_command->vertex_start = context->draw_buffer.vertex_buffer_top;
-		current_command->vertex_end = current_command->vertex_start;
-		current_command->index_start = context->draw_buffer.index_buffer_top;
-		current_command->index_end = current_command->index_start;
+		// The commands of the last frame have been rendered by now
+		_free_commands();
+
+		current_command = context->draw_command_pool.allocate_raw(&context->arena);
+		_track_allocation(context, AllocationType_DrawCommand, sizeof(DrawCommand));
+		_init_draw_command(current_command, nullptr, get_clip_rect(), 0, 0, false);
 	}
 	else
 	{
@@ -86,15 +104,24 @@ void Painter::_start_painter()
 
 void Painter::_restart_painter()
 {
-	Context* context = get_context();
+	// The current command is always empty after _push_command, so it is reset instead of replaced
+	// Replacing it would leave it out of the command list, and out of _free_commands
+	LGUI_ASSERT(current_command->vertex_start == current_command->vertex_end, "Painter was not pushed before restarting");
+	_init_draw_command(current_command, current_command->prev, get_clip_rect(), 0, 0, false);
+}
 
-	DrawCommand* new_command = context->temp_arena->allocate_one<DrawCommand>();
-	new_command->clip_rect = get_clip_rect();
-	new_command->vertex_start = context->draw_buffer.vertex_buffer_top;
-	new_command->vertex_end = new_command->vertex_start;
-	new_command->index_start = context->draw_buffer.index_buffer_top;
-	new_command->index_end = new_command->index_start;
-	current_command = new_command;
+void Painter::_free_commands()
+{
+	// The pushed commands are followed by the current command, which is the last in the list
+	if (current_command)
+	{
+		Context* context = get_context();
+		context->draw_command_pool.free_list(first_command ? first_command : current_command, current_command);
+	}
+
+	first_command = nullptr;
+	last_command = nullptr;
+	current_command = nullptr;
 }
 
 static void _move_draw_command_vertices(DrawCommand* it, usize vertex_start, usize vertex_end, v2 movement)
@@ -136,9 +163,17 @@ void Painter::push_clip_rect(Rect rect)
 	clip_rect_stack[clip_rect_stack_top] = new_rect;
 	++clip_rect_stack_top;
 
+	stats.clip_rect_pushes += 1;
+	get_context()->draw_buffer.stats.clip_rect_pushes += 1;
+
 	current_command->clip_rect = new_rect;
 }
 
+const DrawStats& Painter::get_completed_stats()
+{
+	return frame_last_updated == get_context()->current_frame ? prev_stats : stats;
+}
+
 Rect Painter::get_clip_rect()
 {
 	return clip_rect_stack_top > 0 ? 
@@ -174,12 +209,25 @@ inline static bool has_vertex_space(Painter* painter, usize vert_count)
 		context->draw_buffer.vertex_buffer_length;
 }
 
-// Has enough space for count amount of vertices
+// Has enough space for count amount of triangles
 inline static bool has_index_space(Painter* painter, usize tri_count)
 {
 	Context* context = get_context();
 
-	return painter->current_command->index_end + tri_count < context->draw_buffer.index_buffer_length;
+	return painter->current_command->index_end + tri_count * 3 <= context->draw_buffer.index_buffer_length;
+}
+
+// Has space for both, otherwise the draw is dropped and counted in the stats
+inline static bool has_draw_space(Painter* painter, usize vert_count, usize tri_count)
+{
+	if (has_vertex_space(painter, vert_count) && has_index_space(painter, tri_count))
+	{
+		return true;
+	}
+
+	painter->stats.dropped_draws += 1;
+	get_context()->draw_buffer.stats.dropped_draws += 1;
+	return false;
 }
 
 // Returns index
@@ -318,6 +366,12 @@ void Painter::draw_rectangle(v2 pos, v2 size, Color color, v2 uv1, v2 uv2)
 
 	// Optimised path (manual inlining)
 
+	// Drop the rectangle instead of writing past the end of the draw buffer
+	if (!has_draw_space(this, 4, 2))
+	{
+		return;
+	}
+
 	Context* context = get_context();
 
 	//ColorU32 color32 = color32_from_f32_color(color);
@@ -384,7 +438,7 @@ void Painter::draw_rectangle(v2 pos, v2 size, Color color)
 
 void Painter::draw_rectangle_gradient(v2 pos, v2 size, Color c1, Color c2, Color c3, Color c4)
 {
-	if (!has_vertex_space(this, 4) || !has_index_space(this, 2))
+	if (!has_draw_space(this, 4, 2))
 	{
 		return;
 	}
@@ -459,7 +513,11 @@ f32 Painter::draw_text(Font* font, const char* text, v2 pos, f32 spacing, Color
 	f32 x_off = 0.f;
 	usize len = strlen(text);
 
-
+	// Drop the text instead of writing past the end of the draw buffer, the caller still gets the width
+	if (!has_draw_space(this, 4 * len, 2 * len))
+	{
+		return font->text_width(text, len, spacing);
+	}
 
 	Context* context = get_context();
 
@@ -531,7 +589,11 @@ f32 Painter::draw_text(Font* font, const char* text, usize text_length, v2 pos,
 	f32 x_off = 0.f;
 	const usize len = text_length;
 
-
+	// Drop the text instead of writing past the end of the draw buffer, the caller still gets the width
+	if (!has_draw_space(this, 4 * len, 2 * len))
+	{
+		return font->text_width(text, len, spacing);
+	}
 
 	Context* context = get_context();
 
@@ -653,7 +715,7 @@ void Painter::end_triangle_strip()
 
 void Painter::add_strip_triangle(v2 pos, Color color, v2 uv)
 {
-	if (!has_vertex_space(this, 1) || !has_index_space(this, 1))
+	if (!has_draw_space(this, 1, 1))
 	{
 		return;
 	}
@@ -817,6 +879,7 @@ void Painter::draw_rounded_rectangle(Rect rect, f32 corner_size[4], Color color)
 void rl_render()
 {
 	Context* context = get_context();
+	LGUI_PROFILE_ZONE("rl_render");
 
 	DrawBuffer& draw_buffer = context->draw_buffer;
 
@@ -913,6 +976,8 @@ void rl_render()
 			// TODO: custom textures
 
 			rlDrawVertexArrayElements(command->index_start, command->index_end - command->index_start, nullptr);
+			panel->painter.stats.draw_calls += 1;
+			draw_buffer.stats.draw_calls += 1;
 		}
 	}
 
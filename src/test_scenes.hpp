@@ -0,0 +1,88 @@
+#pragma once
+#include "lag_gui.hpp"
+#include <vector>
+
+using v2 = lgui::v2;
+using Rect = lgui::Rect;
+using f32 = lgui::f32;
+
+// Test scenes, shared between the demo application and the benchmarks
+
+struct Note {
+	int tone;
+	float x;
+	float width;
+	int id;
+};
+
+struct NoteArea {
+	v2 pos;
+	v2 scale;
+	std::vector<Note> notes;
+	int id_counter;
+
+	v2 mouse_on_press;
+	Note note_on_press;
+};
+
+struct LayoutTest {
+	int h_align;
+	int v_align;
+	bool horizontal;
+	bool full_width;
+	bool enable;
+	int layout_count;
+};
+
+struct WidgetTest {
+	bool check;
+	int radio;
+	char string[16];
+};
+
+void area_test(NoteArea& area);
+void layout_test(LayoutTest& test);
+void widget_test(WidgetTest& test);
+void app_test();
+void misc_test();
+void fake_console();
+// Scratch area for trying out widgets
+void presentation();
+// Adds a line to the fake console
+void print(const char* format, ...);
+
+// Style used by the test scenes
+lgui::Style make_test_style(lgui::Font* font);
+
+// Widgets used by the stress scene, they are placed round robin
+enum StressWidgets {
+	StressWidget_Button = 1 << 0,
+	StressWidget_Text = 1 << 1,
+	StressWidget_Checkbox = 1 << 2,
+	StressWidget_Slider = 1 << 3,
+	StressWidget_TreeNode = 1 << 4, // Also used as the nesting container, otherwise a vertical layout is used
+	StressWidget_All = (1 << 5) - 1,
+};
+
+// Generated scene for measuring how the library scales
+struct StressTest {
+	int panel_count;
+	int widget_count; // Per panel
+	int depth; // Nesting depth of the containers in a panel
+	int widget_mix; // StressWidgets
+	bool docked; // Dock the panels in groups of four (splits and tabs), otherwise they are floating
+
+	// Widget state
+	bool check;
+	f32 slider;
+};
+
+void stress_test(StressTest& test);
+
+// Everything the example application shows, the replay benchmark runs the same frames
+struct ExampleApp {
+	LayoutTest layout;
+	WidgetTest widget;
+};
+
+void example_app_frame(ExampleApp& app);
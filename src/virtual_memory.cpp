@@ -0,0 +1,148 @@
+// Platform code of the virtual memory arenas
+// Only includes basic.hpp, windows.h conflicts with raylib
+#include "basic.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace lgui {
+
+static usize _round_up(usize size, usize granularity)
+{
+	return (size + granularity - 1) / granularity * granularity;
+}
+
+static byte* _reserve_pages(usize size, bool huge_pages)
+{
+#ifdef _WIN32
+	// Large pages need the SeLockMemoryPrivilege and cannot be committed on demand, so they are not used
+	(void)huge_pages;
+	return (byte*)VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+	usize alignment = huge_pages ? HUGE_PAGE_SIZE : 0;
+	void* mapping = mmap(nullptr, size + alignment, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (mapping == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	byte* ret = (byte*)mapping;
+	if (huge_pages)
+	{
+		// Unmap the parts before and after the aligned range
+		ret = (byte*)_round_up((usize)mapping, HUGE_PAGE_SIZE);
+		usize head = (usize)(ret - (byte*)mapping);
+		if (head)
+		{
+			munmap(mapping, head);
+		}
+		munmap(ret + size, alignment - head);
+#ifdef MADV_HUGEPAGE
+		madvise(ret, size, MADV_HUGEPAGE);
+#endif
+	}
+	return ret;
+#endif
+}
+
+static void _release_pages(byte* ptr, usize size)
+{
+#ifdef _WIN32
+	(void)size;
+	VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+	munmap(ptr, size);
+#endif
+}
+
+static bool _commit_pages(byte* ptr, usize size)
+{
+#ifdef _WIN32
+	return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+	return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+static void _decommit_pages(byte* ptr, usize size)
+{
+#ifdef _WIN32
+	VirtualFree(ptr, size, MEM_DECOMMIT);
+#else
+	// Give the physical pages back, they read as zero when they are committed again
+	madvise(ptr, size, MADV_DONTNEED);
+	mprotect(ptr, size, PROT_NONE);
+#endif
+}
+
+Arena Arena::reserve(usize reserve_size, usize initial_size, bool huge_pages)
+{
+	Arena ret{};
+	ret.commit_size = huge_pages ? HUGE_PAGE_SIZE : ARENA_COMMIT_SIZE;
+	ret.reserved = _round_up(reserve_size, ret.commit_size);
+	ret.ptr = _reserve_pages(ret.reserved, huge_pages);
+	LGUI_ASSERT(ret.ptr, "Could not reserve the address space of the arena");
+	if (!ret.grow(initial_size))
+	{
+		LGUI_ASSERT(false, "Could not commit the initial size of the arena");
+	}
+	return ret;
+}
+
+void Arena::release()
+{
+	if (reserved)
+	{
+		_release_pages(ptr, reserved);
+	}
+	*this = {};
+}
+
+bool Arena::grow(usize size)
+{
+	// Fixed memory (from_memory) has no commit size and can't grow
+	if (!reserved)
+	{
+		return size <= length;
+	}
+
+	usize new_length = _round_up(size, commit_size);
+	if (new_length > reserved)
+	{
+		return false;
+	}
+	if (new_length <= length)
+	{
+		return true;
+	}
+
+	if (!_commit_pages(ptr + length, new_length - length))
+	{
+		return false;
+	}
+	length = new_length;
+	return true;
+}
+
+void Arena::trim()
+{
+	if (!reserved)
+	{
+		return;
+	}
+
+	usize keep = _round_up(LGUI_MAX(recent_high_water, used), commit_size);
+	if (keep < length)
+	{
+		_decommit_pages(ptr + keep, length - keep);
+		length = keep;
+	}
+	recent_high_water = used;
+}
+
+}
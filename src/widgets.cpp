@@ -21,51 +21,55 @@ static Color lerp_color(Color c1, Color c2, f32 t)
 	};
 }
 
-InputResult button(const char* name)
+InputResult button(Label name)
 {
-	ID id = get_id(name);
 	const Style& style = get_style();
 
 	// Rect
+	ID id = get_id(name);
 	Font* font = style.default_font;
-	f32 text_width = font->text_width(name, 0);
-	Box* box = make_box(name, px(text_width + 4, font->height), BoxFlag_DrawText | BoxFlag_DrawRectangle);
-	box->font = font;
-	box->text_length = strlen(name);
-	box->text = copy_string(get_context()->temp_arena, name, box->text_length);
+	f32 text_width;
+	const char* label = _intern_string(name, font, &text_width);
+	Box* box = make_box(id, px(text_width + 4, font->height), BoxFlag_DrawText | BoxFlag_DrawRectangle);
+	BoxDrawData* data = box->get_draw_data();
+	data->font = font;
+	data->text_length = name.length;
+	data->text = label;
+	data->text_width = text_width;
 	box->h_align = 0;
 	box->v_align = 0;
 
 	InputResult input = handle_element_input(box->prev_rect(), id);
 	box->update_t_towards(input.hover, input.down);
-	Color color = lerp_color(lerp_color(style.button_background, style.button_background_hover, box->hover_t), style.button_background_down, box->active_t);
+	Color color = lerp_color(lerp_color(style.button_background, style.button_background_hover, data->hover_t), style.button_background_down, data->active_t);
 
-	box->color = color;
-	box->text_color = style.button_text;
+	data->color = color;
+	data->text_color = style.button_text;
 
 	return input;
 }
 
-InputResult button(const char* name, Size2 size)
+InputResult button(Label name, Size2 size)
 {
 	const Style& style = get_style();
 
 	// Rect
+	ID id = get_id(name);
 	Font* font = style.default_font;
-	f32 text_width = font->text_width(name, 0);
-	Box* box = make_box(name, size, BoxFlag_DrawText | BoxFlag_DrawRectangle);
-	box->font = font;
-	box->text_length = strlen(name);
-	box->text = copy_string(get_context()->temp_arena, name, box->text_length);
+	Box* box = make_box(id, size, BoxFlag_DrawText | BoxFlag_DrawRectangle);
+	BoxDrawData* data = box->get_draw_data();
+	data->font = font;
+	data->text_length = name.length;
+	data->text = _intern_string(name, font, &data->text_width);
 	box->h_align = 0;
 	box->v_align = 0;
 
-	InputResult input = handle_element_input(box->prev_rect(), box->id);
+	InputResult input = handle_element_input(box->prev_rect(), id);
 	box->update_t_towards(input.hover, input.down);
-	Color color = lerp_color(lerp_color(style.button_background, style.button_background_hover, box->hover_t), style.button_background_down, box->active_t);
+	Color color = lerp_color(lerp_color(style.button_background, style.button_background_hover, data->hover_t), style.button_background_down, data->active_t);
 
-	box->color = color;
-	box->text_color = style.button_text;
+	data->color = color;
+	data->text_color = style.button_text;
 
 	return input;
 }
@@ -130,69 +134,95 @@ Box* draw_hook(Size2 size, DrawHook hook)
 	return ret;
 }
 
-void text(const char* text, bool static_string)
+// Static strings are drawn from the caller's memory, others are interned
+static const char* _text_label(const Label& text, bool static_string, Font* font, f32* text_width)
 {
-	const Style& style = get_style();
-
-	// Rect
-	Font* font = style.default_font;
-	f32 text_width = font->text_width(text, 0);
-	Box* box = make_box(box_generate_id(), px(text_width, font->height), BoxFlag_DrawText);
-	box->font = font;
-
-	usize len = strlen(text);
-	box->text_length = len;
 	if (static_string)
 	{
-		box->text = text;
-	}
-	else
-	{
-		box->text = copy_string(get_context()->temp_arena, text, len);
+		*text_width = font->text_width(text.text, text.length, 0.f);
+		return text.text;
 	}
+	return _intern_string(text, font, text_width);
+}
 
-	box->h_align = 0;
-	box->v_align = 0;
-	box->text_color = {1.f, 1.f, 1.f, 1.f};
+static void _text_box(Font* font, const char* label, usize len, f32 text_width, Size2 size, i8 h_align, i8 v_align)
+{
+	Box* box = make_box(box_generate_id(), size, BoxFlag_DrawText);
+	BoxDrawData* data = box->get_draw_data();
+	data->font = font;
+	data->text_length = len;
+	data->text = label;
+	data->text_width = text_width;
+
+	box->h_align = h_align;
+	box->v_align = v_align;
+	data->text_color = {1.f, 1.f, 1.f, 1.f};
 }
 
-void text(const char* text, Size2 size, i8 h_align, i8 v_align, bool static_string)
+void text(Label text, bool static_string)
 {
-	const Style& style = get_style();
+	Font* font = get_style().default_font;
+	f32 text_width;
+	const char* label = _text_label(text, static_string, font, &text_width);
+	_text_box(font, label, text.length, text_width, px(text_width, font->height), 0, 0);
+}
 
-	// Rect
-	Font* font = style.default_font;
-	f32 text_width = font->text_width(text, 0);
-	Box* box = make_box(box_generate_id(), size, BoxFlag_DrawText);
-	box->font = font;
+void text(Label text, Size2 size, i8 h_align, i8 v_align, bool static_string)
+{
+	Font* font = get_style().default_font;
+	f32 text_width;
+	const char* label = _text_label(text, static_string, font, &text_width);
+	_text_box(font, label, text.length, text_width, size, h_align, v_align);
+}
 
-	usize len = strlen(text);
-	box->text_length = len;
-	if (static_string)
+void text(const char* string, bool static_string)
+{
+	if (!static_string)
 	{
-		box->text = text;
+		text(Label(string), false);
+		return;
 	}
-	else
+
+	// Static strings are not interned, so they don't need the hash of a Label
+	Font* font = get_style().default_font;
+	usize len = strlen(string);
+	f32 text_width = font->text_width(string, len, 0.f);
+	_text_box(font, string, len, text_width, px(text_width, font->height), 0, 0);
+}
+
+void text(const char* string, Size2 size, i8 h_align, i8 v_align, bool static_string)
+{
+	if (!static_string)
 	{
-		box->text = copy_string(get_context()->temp_arena, text, len);
+		text(Label(string), size, h_align, v_align, false);
+		return;
 	}
 
-	box->h_align = h_align;
-	box->v_align = v_align;
-	box->text_color = {1.f, 1.f, 1.f, 1.f};
+	Font* font = get_style().default_font;
+	usize len = strlen(string);
+	f32 text_width = font->text_width(string, len, 0.f);
+	_text_box(font, string, len, text_width, size, h_align, v_align);
 }
 
 void textf(const char* format, ...)
 {
 	va_list args;
 	va_start(args, format);
+	// The first pass consumes the arguments
+	va_list args_copy;
+	va_copy(args_copy, args);
 
 	int size = vsnprintf(nullptr, 0, format, args);
-	if (size < 0) return;
-	char* memory = (char*)get_context()->temp_arena->allocate_raw((usize)(size + 1));
-	vsnprintf(memory, size + 1, format, args);
-
 	va_end(args);
+	if (size < 0)
+	{
+		va_end(args_copy);
+		return;
+	}
+	// Formatted text changes from frame to frame, it lives until the end of the frame instead of being interned
+	char* memory = (char*)get_context()->temp_arena->allocate_raw((usize)(size + 1));
+	vsnprintf(memory, size + 1, format, args_copy);
+	va_end(args_copy);
 
 	text(memory, true);
 }
@@ -202,7 +232,7 @@ static v2 _wrapped_text_size(const char* text, usize len, f32 width, Font* font)
 
 }
 
-InputResult radio_button(const char* name, int option, int* selected)
+InputResult radio_button(Label name, int option, int* selected)
 {
 	ID id = get_id(name);
 	RetainedData* retained = get_retained_data(id);
@@ -210,7 +240,7 @@ InputResult radio_button(const char* name, int option, int* selected)
 
 	// Box
 	f32 size = style.line_height();
-	Box* box = push_box(name, px(size, size), 0);
+	Box* box = push_box(id, px(size, size), 0);
 	box->h_align = 0;
 	box->v_align = 0;
 
@@ -229,7 +259,7 @@ InputResult radio_button(const char* name, int option, int* selected)
 	{
 		// Second circle
 		f32 inside_size = size * lerp(0.2f, 0.6f, retained->active_t);
-		Box* inside = make_box(name, px(inside_size, inside_size), 0);
+		Box* inside = make_box(get_id(name), px(inside_size, inside_size), 0);
 		Color c = style.radio_button_inside;
 		c.a = retained->active_t;
 		inside->set_circle(c);
@@ -240,14 +270,14 @@ InputResult radio_button(const char* name, int option, int* selected)
 	return input;
 }
 
-InputResult slider_value(const char* name, Size2 size, f32 min, f32 max, f32* value)
+InputResult slider_value(Label name, Size2 size, f32 min, f32 max, f32* value)
 {
 	ID id = get_id(name);
 	RetainedData* retained = get_retained_data(id);
 	const Style& style = get_style();
 
 	// Rect
-	Box* box = push_box(name, size, BoxFlag_DrawRectangle);
+	Box* box = push_box(id, size, BoxFlag_DrawRectangle);
 	box->h_align = -1;
 	box->v_align = -1;
 	box->padding = {3.f, 3.f};
@@ -268,14 +298,14 @@ InputResult slider_value(const char* name, Size2 size, f32 min, f32 max, f32* va
 
 	retained->update_t_towards(input.hover, input.down);
 	Color color = lerp_color(lerp_color(style.button_background, style.button_background_hover, retained->hover_t), style.button_background_down, retained->active_t);
-	box->color = color;
+	box->get_draw_data()->color = color;
 
 	pop_box();
 
 	return input;
 }
 
-InputResult checkbox(const char* name, bool* value)
+InputResult checkbox(Label name, bool* value)
 {
 	ID id = get_id(name);
 	RetainedData* retained = get_retained_data(id);
@@ -283,7 +313,7 @@ InputResult checkbox(const char* name, bool* value)
 
 	// Box
 	f32 size = style.line_height();
-	Box* box = push_box(name, px(size, size), 0);
+	Box* box = push_box(id, px(size, size), 0);
 	box->h_align = 0;
 	box->v_align = 0;
 
@@ -302,7 +332,7 @@ InputResult checkbox(const char* name, bool* value)
 	{
 		// Second circle
 		f32 inside_size = size * lerp(0.2f, 0.6f, retained->active_t);
-		Box* inside = make_box(name, px(inside_size, inside_size), 0);
+		Box* inside = make_box(get_id(name), px(inside_size, inside_size), 0);
 		Color c = style.radio_button_inside;
 		c.a = retained->active_t;
 		inside->set_rectangle(c);
@@ -316,14 +346,15 @@ InputResult checkbox(const char* name, bool* value)
 static void _open_triangle(Size2 size, Color color, f32 t)
 {
 	Box* box = make_box(box_generate_id(), size, 0);
-	box->active_t = t;
-	box->color = color;
+	BoxDrawData* data = box->get_draw_data();
+	data->active_t = t;
+	data->color = color;
 	box->set_draw_hook([](Box* box, Painter& painter, Rect rect) {
-		draw_open_triangle(&painter, rect.top_left, rect.size().x, box->active_t, box->color);
+		draw_open_triangle(&painter, rect.top_left, rect.size().x, box->draw_data->active_t, box->draw_data->color);
 	});
 }
 
-bool begin_fancy_collapse_header(const char* name)
+bool begin_fancy_collapse_header(Label name)
 {
 	ID id = get_id(name);
 	push_id_raw(id);
@@ -388,7 +419,7 @@ void end_fancy_collapse_header()
 	pop_id();
 }
 
-bool begin_tree_node(const char* name)
+bool begin_tree_node(Label name)
 {
 	ID id = get_id(name);
 	push_id_raw(id);
@@ -474,7 +505,7 @@ void end_tree_node()
 	pop_id();
 }
 
-bool begin_button_menu(const char* name)
+bool begin_button_menu(Label name)
 {
 	ID id = get_id(name);
 	RetainedData* retained = get_retained_data(id);
@@ -482,11 +513,14 @@ bool begin_button_menu(const char* name)
 
 	// Rect
 	Font* font = style.default_font;
-	f32 text_width = font->text_width(name, 0);
-	Box* box = make_box(name, {px(text_width + 4), rem(1.f)}, BoxFlag_DrawText | BoxFlag_DrawRectangle);
-	box->font = font;
-	box->text = name;
-	box->text_length = strlen(name);
+	f32 text_width;
+	const char* label = _intern_string(name, font, &text_width);
+	Box* box = make_box(id, {px(text_width + 4), rem(1.f)}, BoxFlag_DrawText | BoxFlag_DrawRectangle);
+	BoxDrawData* data = box->get_draw_data();
+	data->font = font;
+	data->text = label;
+	data->text_length = name.length;
+	data->text_width = text_width;
 	box->h_align = 0;
 	box->v_align = 0;
 
@@ -494,15 +528,15 @@ bool begin_button_menu(const char* name)
 	retained->update_t_towards(input.hover, input.down);
 	Color color = lerp_color(lerp_color(style.button_background, style.button_background_hover, retained->hover_t), style.button_background_down, retained->active_t);
 
-	box->color = color;
-	box->text_color = style.button_text;
+	data->color = color;
+	data->text_color = style.button_text;
 
 	if (input.clicked)
 	{
 		open_panel(id);
 	}
 
-	bool ret = begin_window(name, v2{1.f, 1.f}, PanelFlag_BeginClosed | PanelFlag_NoTitleBar |
+	bool ret = begin_window(name.text, v2{1.f, 1.f}, PanelFlag_BeginClosed | PanelFlag_NoTitleBar |
 		PanelFlag_AutoResizeHorizontal | PanelFlag_AutoResizeVertical);
 	if (ret)
 	{
@@ -579,8 +613,8 @@ bool _input_text(ID id, Rect rect, char* buffer, usize buffer_size, usize* text_
 			return GetClipboardText();
 		};
 		auto set_clipboard_text = [&](char* buffer, usize len) {
-			auto marker = context->temp_arena.make_marker();
-			char* temp_buffer = (char*)context->temp_arena.allocate_raw(len + 1);
+			ArenaMarker scratch = get_scratch();
+			char* temp_buffer = (char*)scratch.arena->allocate_raw(len + 1);
 			memcpy(temp_buffer, buffer, len);
 			temp_buffer[len] = 0;
 			SetClipboardText(temp_buffer);
@@ -0,0 +1,47 @@
+// Tests of the arenas that don't need a window or the rest of the library
+
+#include "tests.hpp"
+#include "basic.hpp"
+#include <stdlib.h>
+
+// Fixed arenas can't grow, overflowing them must fail instead of dividing by the 0 commit size
+static void test_fixed_arena_overflow()
+{
+	const lgui::usize size = 4096;
+	void* memory = malloc(size);
+	lgui::Arena arena = lgui::Arena::from_memory(memory, size);
+
+	CHECK(arena.grow(size));
+	CHECK(!arena.grow(size + 1));
+	CHECK(!arena.grow(size * 16));
+
+	// Filling it exactly is still fine
+	CHECK(arena.allocate_raw(size) == memory);
+	CHECK(arena.used == size);
+	CHECK(!arena.grow(arena.used + 1));
+
+	free(memory);
+}
+
+static void test_reserved_arena_grow()
+{
+	lgui::Arena arena = lgui::Arena::reserve(4 * lgui::ARENA_COMMIT_SIZE, 0);
+
+	CHECK(arena.length == 0);
+	CHECK(arena.grow(1));
+	CHECK(arena.length == lgui::ARENA_COMMIT_SIZE);
+	CHECK(!arena.grow(arena.reserved + 1));
+
+	// Allocations commit the pages they need
+	lgui::byte* bytes = (lgui::byte*)arena.allocate(2 * lgui::ARENA_COMMIT_SIZE);
+	CHECK(bytes[2 * lgui::ARENA_COMMIT_SIZE - 1] == 0);
+	CHECK(arena.length == 2 * lgui::ARENA_COMMIT_SIZE);
+
+	arena.release();
+}
+
+void run_arena_tests()
+{
+	test_fixed_arena_overflow();
+	test_reserved_arena_grow();
+}
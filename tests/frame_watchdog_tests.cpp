@@ -0,0 +1,94 @@
+// Tests of the frame watchdog captures, runs frames headless with the provided mouse input
+
+#include "tests.hpp"
+#include "lag_gui.hpp"
+#include <stdlib.h>
+#include <string.h>
+
+static char* read_text_file(const char* filename)
+{
+	FILE* file;
+	if (fopen_s(&file, filename, "rb"))
+	{
+		return nullptr;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	char* ret = (char*)malloc((size_t)size + 1);
+	size_t read = fread(ret, 1, (size_t)size, file);
+	ret[read] = 0;
+	fclose(file);
+	return ret;
+}
+
+static void docked_frame()
+{
+	lgui::MouseState mouse{};
+	lgui::begin_frame(1.f / 60.f, mouse);
+	if (lgui::begin_window("Target", lgui::Rect::from_pos_size({10.f, 10.f}, {300.f, 300.f}), 0))
+	{
+		lgui::text("Target content", true);
+		lgui::end_window();
+	}
+	if (lgui::begin_window("Tool", lgui::Rect::from_pos_size({400.f, 10.f}, {300.f, 300.f}), 0))
+	{
+		lgui::text("Tool content", true);
+		lgui::end_window();
+	}
+	if (lgui::begin_window("Floating", lgui::Rect::from_pos_size({10.f, 400.f}, {300.f, 300.f}), 0))
+	{
+		lgui::text("Floating content", true);
+		lgui::end_window();
+	}
+	lgui::dock_panel("Tool", "Target", lgui::DockEntry_Right);
+	lgui::end_frame();
+}
+
+// Docked tabs are not in the depth list, the capture must still have their boxes
+static void test_capture_has_docked_panels()
+{
+	lgui::Context* context = lgui::init(16);
+	context->app_window_size = {1280.f, 800.f};
+	lgui::Font* font = context->atlas.add_font("resources/fonts/montserrat/Montserrat-Regular.ttf", 18);
+	context->atlas.build(false);
+	lgui::Style style{};
+	style.default_font = font;
+	lgui::push_style(style);
+
+	// The first frame creates the panels, the dock command docks them at its end
+	docked_frame();
+	lgui::Panel* tool = lgui::get_panel(lgui::get_id("Tool"));
+	CHECK(tool && tool->is_docked());
+
+	// Every frame goes over this budget, the capture is written by frame_watchdog_end
+	lgui::frame_watchdog_begin(0.001f, "lgui_test_watchdog_", 1);
+	docked_frame();
+	lgui::u32 frame = context->current_frame;
+	lgui::frame_watchdog_end();
+
+	char filename[64];
+	snprintf(filename, sizeof(filename), "lgui_test_watchdog_%u.txt", frame);
+	char* capture = read_text_file(filename);
+	CHECK(capture);
+	if (capture)
+	{
+		CHECK(strstr(capture, "panel \"Tool\""));
+		CHECK(strstr(capture, "\"Tool content\""));
+		CHECK(strstr(capture, "panel \"Target\""));
+		CHECK(strstr(capture, "\"Target content\""));
+		CHECK(strstr(capture, "panel \"Floating\""));
+		// The dock root painter draws both tabs and is named after them
+		CHECK(strstr(capture, "painter \"dock: Target, Tool\""));
+		CHECK(!strstr(capture, "painter \"\""));
+		free(capture);
+	}
+	remove(filename);
+
+	lgui::deinit();
+}
+
+void run_frame_watchdog_tests()
+{
+	test_capture_has_docked_panels();
+}
@@ -0,0 +1,20 @@
+// Run from the repository root so the fonts can be found
+// Returns a nonzero exit code when a check fails
+
+#include "tests.hpp"
+
+int g_failures = 0;
+
+int main()
+{
+	run_arena_tests();
+	run_frame_watchdog_tests();
+
+	if (g_failures)
+	{
+		printf("%d checks failed\n", g_failures);
+		return 1;
+	}
+	printf("All checks passed\n");
+	return 0;
+}
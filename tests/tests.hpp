@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdio.h>
+
+// Counted by main, which returns a nonzero exit code when a check failed
+extern int g_failures;
+
+#define CHECK(condition) do { if (!(condition)) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); ++g_failures; } } while (0)
+
+void run_arena_tests();
+void run_frame_watchdog_tests();